@@ -3,7 +3,14 @@ LOCAL_PATH := $(call my-dir)
 # Share library
 include $(CLEAR_VARS)
 LOCAL_SRC_FILES := \
-	g2d_basic.c
+	g2d_basic.c \
+	../common/g2d_bench.c \
+	../common/g2d_format.c \
+	../common/g2d_hugepage.c \
+	../common/g2d_inplace.c \
+	../common/g2d_trace.c \
+	../common/g2d_cache_stats.c \
+	../common/g2d_alloc_stats.c
 
 LOCAL_CFLAGS += -DBUILD_FOR_ANDROID -DIMX6Q
 
@@ -15,7 +22,7 @@ else
 LOCAL_SHARED_LIBRARIES += libg2d
 endif
 
-LOCAL_C_INCLUDES := $(LOCAL_PATH)
+LOCAL_C_INCLUDES := $(LOCAL_PATH) $(LOCAL_PATH)/../common
 
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../include/ $(FSL_PROPRIETARY_PATH)/fsl-proprietary/include/
 
@@ -12,19 +12,35 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/time.h>
+#include <unistd.h>
 
 #include "g2d.h"
+#include "g2d_alloc_stats.h"
+#include "g2d_bench.h"
+#include "g2d_cache_stats.h"
+#include "g2d_format.h"
+#include "g2d_hugepage.h"
+#include "g2d_inplace.h"
+#include "g2d_trace.h"
 
 #define TEST_WIDTH 1920
 #define TEST_HEIGHT 1080
 #define SIZE_1K 1024
 #define SIZE_1M (1024 * 1024)
 
+#define OPEN_STRESS_LOOP 2048
+#define ALLOC_STRESS_LOOP 128
+#define FIRST_BLIT_SIZE 64
+
+/* Moves the planes off the 64 byte alignment, keeping the 16 byte one. */
+#define PLANE_SKEW 32
+
 /*
  * Parses a string of the form "nv12-yu12".
  *
@@ -66,35 +82,479 @@ static int parseFormat(const char *fmtStr, int *pSrcFmt, int *pDstFmt) {
   return 0;
 }
 
+/*
+ * The cold start path of an application: open, allocate a source and a
+ * destination and blit once. Measured before anything else warms the driver.
+ */
+static int test_first_blit(long long main_us, long long age_at_main_us) {
+  struct g2d_surface src, dst;
+  struct g2d_buf *s_buf, *d_buf;
+  void *handle;
+  long long t0, t_open, t_alloc, t_blit;
+  int size = FIRST_BLIT_SIZE * FIRST_BLIT_SIZE * 4;
+
+  printf("---------------- time to first blit ------------------\n");
+  t0 = bench_get_time_us();
+  if (g2d_open(&handle)) {
+    printf("g2d_open fail.\n");
+    return -ENOTTY;
+  }
+  t_open = bench_get_time_us();
+
+  s_buf = g2d_alloc(size, 0);
+  d_buf = g2d_alloc(size, 0);
+  if (!s_buf || !d_buf) {
+    printf("g2d_alloc fail.\n");
+    if (s_buf)
+      g2d_free(s_buf);
+    if (d_buf)
+      g2d_free(d_buf);
+    g2d_close(handle);
+    return -ENOMEM;
+  }
+  t_alloc = bench_get_time_us();
+
+  memset(&src, 0, sizeof(src));
+  src.format = G2D_RGBA8888;
+  src.planes[0] = s_buf->buf_paddr;
+  src.right = src.stride = src.width = FIRST_BLIT_SIZE;
+  src.bottom = src.height = FIRST_BLIT_SIZE;
+  src.rot = G2D_ROTATION_0;
+  dst = src;
+  dst.planes[0] = d_buf->buf_paddr;
+
+  g2d_blit(handle, &src, &dst);
+  g2d_finish(handle);
+  t_blit = bench_get_time_us();
+
+  if (age_at_main_us >= 0)
+    printf("first blit done %lldus after exec (tick resolution), ",
+           age_at_main_us + t_blit - main_us);
+  printf("%lldus after main\n", t_blit - main_us);
+  printf("    open %lldus, 2 allocs %lldus, blit + finish %lldus\n",
+         t_open - t0, t_alloc - t_open, t_blit - t_alloc);
+
+  g2d_free(s_buf);
+  g2d_free(d_buf);
+  g2d_close(handle);
+  return 0;
+}
+
+static int test_open_close_latency(void) {
+  double *open_us = malloc(sizeof(double) * OPEN_STRESS_LOOP);
+  double *close_us = malloc(sizeof(double) * OPEN_STRESS_LOOP);
+  void *handle;
+  long long t;
+  int i, ret = 0;
+
+  printf("---------------- g2d_open/close stress test ----------\n");
+  if (!open_us || !close_us) {
+    free(open_us);
+    free(close_us);
+    return -ENOMEM;
+  }
+
+  for (i = 0; i < OPEN_STRESS_LOOP; i++) {
+    t = bench_get_time_ns();
+    if (g2d_open(&handle)) {
+      printf("g2d_open/close stress test fail.\n");
+      ret = -ENOTTY;
+      break;
+    }
+    open_us[i] = (bench_get_time_ns() - t) / 1e3;
+
+    t = bench_get_time_ns();
+    g2d_close(handle);
+    close_us[i] = (bench_get_time_ns() - t) / 1e3;
+  }
+
+  bench_report_latency("g2d_open", open_us, i);
+  bench_report_latency("g2d_close", close_us, i);
+
+  free(open_us);
+  free(close_us);
+  return ret;
+}
+
+/*
+ * Latency of g2d_alloc by size and cacheability, of g2d_free and of
+ * g2d_buf_export_fd, cacheable buffers cycling through 1..4MB and
+ * non-cacheable ones through 1..16MB.
+ */
+static void test_alloc_latency(void) {
+  enum { CACHED_SIZES = 4, UNCACHED_SIZES = 16 };
+  double cached_us[CACHED_SIZES][ALLOC_STRESS_LOOP / CACHED_SIZES];
+  double uncached_us[UNCACHED_SIZES][ALLOC_STRESS_LOOP / UNCACHED_SIZES];
+  double free_us[ALLOC_STRESS_LOOP * 2], export_us[ALLOC_STRESS_LOOP];
+  int frees = 0, exports = 0;
+  struct g2d_buf *buf;
+  char name[64];
+  long long t;
+  int i, fd;
+
+  printf("---------------- g2d_alloc stress test ---------------\n");
+  for (i = 0; i < ALLOC_STRESS_LOOP; i++) {
+    t = bench_get_time_ns();
+    buf = g2d_alloc(SIZE_1M * ((i % CACHED_SIZES) + 1), 1);
+    cached_us[i % CACHED_SIZES][i / CACHED_SIZES] =
+        (bench_get_time_ns() - t) / 1e3;
+    if (buf) {
+      t = bench_get_time_ns();
+      g2d_free(buf);
+      free_us[frees++] = (bench_get_time_ns() - t) / 1e3;
+    } else {
+      printf("g2d_alloc stress test fail\n");
+    }
+
+    t = bench_get_time_ns();
+    buf = g2d_alloc(SIZE_1M * ((i % UNCACHED_SIZES) + 1), 0);
+    uncached_us[i % UNCACHED_SIZES][i / UNCACHED_SIZES] =
+        (bench_get_time_ns() - t) / 1e3;
+    if (buf) {
+      t = bench_get_time_ns();
+      fd = g2d_buf_export_fd(buf);
+      if (fd >= 0) {
+        export_us[exports++] = (bench_get_time_ns() - t) / 1e3;
+        close(fd);
+      }
+
+      t = bench_get_time_ns();
+      g2d_free(buf);
+      free_us[frees++] = (bench_get_time_ns() - t) / 1e3;
+    } else {
+      printf("g2d_alloc stress test fail\n");
+    }
+  }
+
+  for (i = 0; i < CACHED_SIZES; i++) {
+    snprintf(name, sizeof(name), "g2d_alloc %dMB cacheable", i + 1);
+    bench_report_latency(name, cached_us[i], ALLOC_STRESS_LOOP / CACHED_SIZES);
+  }
+  for (i = 0; i < UNCACHED_SIZES; i++) {
+    snprintf(name, sizeof(name), "g2d_alloc %dMB non-cacheable", i + 1);
+    bench_report_latency(name, uncached_us[i],
+                         ALLOC_STRESS_LOOP / UNCACHED_SIZES);
+  }
+  bench_report_latency("g2d_free", free_us, frees);
+  bench_report_latency("g2d_buf_export_fd", export_us, exports);
+}
+
+/*
+ * Converts NV12 and I420 sources to RGBA with the planes laid out by
+ * format_layout, then with every plane PLANE_SKEW bytes past its 64 byte
+ * boundary. Both are accepted, the second misses the fast path.
+ */
+static void test_plane_alignment(void *handle, int width, int height,
+                                 int loops, double peak_gbps) {
+  static const enum g2d_format formats[] = {G2D_NV12, G2D_I420};
+  struct g2d_surface src, dst;
+  struct format_layout layout;
+  struct bench_section sec;
+  struct bench_bytes bytes;
+  struct g2d_buf *s_buf, *d_buf;
+  char label[16];
+  int f, i, p, skew, diff, aligned_us = 0;
+
+  printf("---------------- plane alignment ----------------\n");
+  memset(&src, 0, sizeof(src));
+  memset(&dst, 0, sizeof(dst));
+  dst.format = G2D_RGBA8888;
+  dst.right = dst.width = dst.stride = width;
+  dst.bottom = dst.height = height;
+  format_layout(dst.format, width, height, 0, &layout);
+  d_buf = g2d_alloc(layout.total, 0);
+  if (!d_buf) {
+    printf("plane alignment test fail\n");
+    return;
+  }
+  format_set_planes(&dst, d_buf, &layout);
+
+  for (f = 0; f < (int)(sizeof(formats) / sizeof(formats[0])); f++) {
+    src.format = formats[f];
+    src.right = src.width = src.stride = width;
+    src.bottom = src.height = height;
+    format_layout(src.format, width, height, 0, &layout);
+    s_buf = g2d_alloc(layout.total + PLANE_SKEW, 0);
+    if (!s_buf) {
+      printf("plane alignment test fail\n");
+      break;
+    }
+    memset(s_buf->buf_vaddr, 0x80, layout.total + PLANE_SKEW);
+
+    for (skew = 0; skew <= PLANE_SKEW; skew += PLANE_SKEW) {
+      format_set_planes(&src, s_buf, &layout);
+      for (p = 0; p < layout.desc->planes; p++)
+        src.planes[p] += skew;
+
+      bench_section_begin(&sec);
+      for (i = 0; i < loops; i++)
+        g2d_blit(handle, &src, &dst);
+      g2d_finish(handle);
+      bench_section_end(&sec);
+      diff = sec.elapsed_us / loops;
+      if (diff < 1)
+        diff = 1;
+
+      snprintf(label, sizeof(label), "+%dB", skew);
+      printf("%s->RGBA planes %s time %dus, %dMpixel/s ........\n",
+             layout.desc->name, skew ? label : "aligned", diff,
+             width * height / diff);
+      bench_blit_bytes(&src, &dst, 0, &bytes);
+      bench_report_bytes(&bytes, diff, peak_gbps);
+      bench_section_report(&sec, loops);
+      if (!skew)
+        aligned_us = diff;
+    }
+    printf("%s misaligned planes: %+.1f%% time\n", layout.desc->name,
+           (diff - aligned_us) * 100.0 / aligned_us);
+    g2d_free(s_buf);
+  }
+  g2d_free(d_buf);
+}
+
+/*
+ * CPU copy and compare of two size byte buffers on base pages, transparent
+ * huge pages and hugetlbfs pages, the modes the system cannot provide being
+ * skipped.
+ */
+static void test_huge_pages(size_t size, int loops, double peak_gbps) {
+  struct huge_buf a, b;
+  struct bench_section sec;
+  struct bench_bytes bytes;
+  enum huge_mode mode;
+  int i, diff, mismatches;
+
+  printf("---------------- huge pages ----------------\n");
+  for (mode = HUGE_NONE; mode <= HUGE_HUGETLB; mode++) {
+    huge_alloc(&a, size, mode);
+    huge_alloc(&b, size, mode);
+    if (!a.ptr || !b.ptr || a.mode != mode || b.mode != mode) {
+      printf("huge pages %s not available, skipped\n", huge_mode_name(mode));
+      huge_free(&a);
+      huge_free(&b);
+      continue;
+    }
+
+    // fault the pages in before timing
+    memset(a.ptr, 0x5a, size);
+    memset(b.ptr, 0xa5, size);
+    printf("huge pages %s: %.1fMB of %.1fMB backed by huge pages\n",
+           huge_mode_name(mode), (huge_backed(&a) + huge_backed(&b)) / 1e6,
+           (a.map_size + b.map_size) / 1e6);
+
+    bench_section_begin(&sec);
+    for (i = 0; i < loops; i++)
+      memcpy(b.ptr, a.ptr, size);
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / loops;
+    if (diff < 1)
+      diff = 1;
+
+    printf("cpu copy, huge pages %s time %dus ........\n",
+           huge_mode_name(mode), diff);
+    bench_copy_bytes(size, &bytes);
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, loops);
+
+    mismatches = 0;
+    bench_section_begin(&sec);
+    for (i = 0; i < loops; i++)
+      mismatches += memcmp(a.ptr, b.ptr, size) != 0;
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / loops;
+    if (diff < 1)
+      diff = 1;
+
+    printf("cpu verify, huge pages %s time %dus ........\n",
+           huge_mode_name(mode), diff);
+    bytes.read = 2 * size;
+    bytes.written = 0;
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, loops);
+    if (mismatches)
+      printf("huge pages: copy is different from its source !\n");
+
+    huge_free(&a);
+    huge_free(&b);
+  }
+}
+
 static const struct option longOptions[] = {
     {"help", no_argument, NULL, 'h'},
     {"verbose", no_argument, NULL, 'v'},
     {"source", required_argument, NULL, 's'},
     {"format", required_argument, NULL, 'f'},
     {"times", required_argument, NULL, 't'},
+    {"cpus", required_argument, NULL, 'c'},
+    {"fifo", required_argument, NULL, 'p'},
     {NULL, 0, NULL, 0}};
 
+/* Byte b of each destination word comes from byte order[b] of a source word. */
+static void in_place_reference(const uint8_t *src, uint8_t *ref, int words,
+                               int rows, enum g2d_rotation rot,
+                               const int order[4]) {
+  int mirror_y = rot == G2D_ROTATION_180 || rot == G2D_FLIP_V;
+  int mirror_x = rot == G2D_ROTATION_180 || rot == G2D_FLIP_H;
+  int x, y, b;
+
+  for (y = 0; y < rows; y++) {
+    for (x = 0; x < words; x++) {
+      const uint8_t *s = src + ((mirror_y ? rows - 1 - y : y) * words +
+                                (mirror_x ? words - 1 - x : x)) *
+                                   4;
+      uint8_t *d = ref + (y * words + x) * 4;
+
+      for (b = 0; b < 4; b++)
+        d[b] = s[order[b]];
+    }
+  }
+}
+
+/*
+ * Runs the symmetric blits in place, through a bounce buffer, and checks
+ * them against a CPU reference. Each is then timed in place and to a
+ * separate destination, and the memory of both is compared. The packed YUV
+ * reorder is only checked unrotated, its reference works on 32 bit words.
+ */
+static void test_in_place(void *handle, int width, int height, int loops,
+                          double peak_gbps) {
+  static const struct {
+    const char *name;
+    enum g2d_format src, dst;
+    enum g2d_rotation rot;
+    int order[4];
+  } cases[] = {
+      {"rgba 180", G2D_RGBA8888, G2D_RGBA8888, G2D_ROTATION_180, {0, 1, 2, 3}},
+      {"rgba flip h", G2D_RGBA8888, G2D_RGBA8888, G2D_FLIP_H, {0, 1, 2, 3}},
+      {"rgba flip v", G2D_RGBA8888, G2D_RGBA8888, G2D_FLIP_V, {0, 1, 2, 3}},
+      {"rgba->bgra", G2D_RGBA8888, G2D_BGRA8888, G2D_ROTATION_0, {2, 1, 0, 3}},
+      {"yuyv->uyvy", G2D_YUYV, G2D_UYVY, G2D_ROTATION_0, {1, 0, 3, 2}},
+  };
+  struct g2d_buf *frame, *out, *bounce;
+  struct g2d_surface src, dst;
+  struct bench_section sec;
+  struct bench_bytes bytes;
+  int c, i, size, words, diff;
+  uint32_t *word;
+  uint8_t *ref;
+
+  printf("---------------- in place ----------------\n");
+  memset(&src, 0, sizeof(src));
+  src.right = src.width = src.stride = width;
+  src.bottom = src.height = height;
+  src.format = G2D_RGBA8888;
+  size = width * height * 4;
+
+  frame = g2d_alloc(size, 0);
+  out = g2d_alloc(size, 0);
+  bounce = g2d_alloc(inplace_bounce_size(&src), 0);
+  ref = malloc(size);
+  if (!frame || !out || !bounce || !ref) {
+    printf("in place test fail\n");
+    goto out;
+  }
+  src.planes[0] = frame->buf_paddr;
+
+  for (c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); c++) {
+    src.format = cases[c].src;
+    dst = src;
+    dst.format = cases[c].dst;
+    dst.rot = cases[c].rot;
+    words = width * format_bpp(src.format) / 32;
+
+    word = frame->buf_vaddr;
+    for (i = 0; i < words * height; i++)
+      word[i] = i * 2654435761u;
+    in_place_reference(frame->buf_vaddr, ref, words, height, dst.rot,
+                       cases[c].order);
+
+    if (!inplace_supported(&src, &dst)) {
+      printf("in place %s: not supported in place\n", cases[c].name);
+      continue;
+    }
+    if (inplace_blit(handle, &src, &dst, bounce)) {
+      printf("in place %s: g2d_blit failed\n", cases[c].name);
+      continue;
+    }
+    if (memcmp(frame->buf_vaddr, ref, words * height * 4))
+      printf("in place %s: result is different from the reference !\n",
+             cases[c].name);
+
+    bench_section_begin(&sec);
+    for (i = 0; i < loops; i++)
+      inplace_blit(handle, &src, &dst, bounce);
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / loops;
+    if (diff < 1)
+      diff = 1;
+
+    // every pixel goes through the bounce buffer, so twice
+    printf("in place %s time %dus ........\n", cases[c].name, diff);
+    bench_blit_bytes(&src, &dst, 0, &bytes);
+    bytes.read *= 2;
+    bytes.written *= 2;
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, loops);
+
+    dst.planes[0] = out->buf_paddr;
+    bench_section_begin(&sec);
+    for (i = 0; i < loops; i++)
+      g2d_blit(handle, &src, &dst);
+    g2d_finish(handle);
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / loops;
+    if (diff < 1)
+      diff = 1;
+
+    printf("separate destination %s time %dus ........\n", cases[c].name,
+           diff);
+    bench_blit_bytes(&src, &dst, 0, &bytes);
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, loops);
+  }
+
+  src.format = G2D_RGBA8888;
+  printf("in place memory: %d bytes frame + %d bytes bounce, separate "
+         "destination %d bytes, %.1f%% saved\n",
+         size, inplace_bounce_size(&src), 2 * size,
+         (size - inplace_bounce_size(&src)) * 100.0 / (2 * size));
+
+out:
+  free(ref);
+  if (frame)
+    g2d_free(frame);
+  if (out)
+    g2d_free(out);
+  if (bounce)
+    g2d_free(bounce);
+}
+
 int main(int argc, char *argv[]) {
-  int i, j, diff = 0;
-  struct timeval tv1, tv2;
+  long long main_us = bench_get_time_us();
+  long long age_at_main_us = bench_process_age_us();
+  int i, j, diff = 0, ret;
+  struct bench_section sec;
+  struct cache_stats cache_start, cache_end, cache;
   int g2d_feature_available = 0;
   int test_width = 0, test_height = 0;
   void *handle = NULL;
   struct g2d_surface src, dst;
   struct g2d_buf *s_buf, *d_buf;
-  void *v_buf1, *v_buf2;
+  struct huge_buf v_buf1, v_buf2;
   int srcFmt = G2D_RGBA8888;
   int dstFmt = G2D_RGBA8888;
   int test_loop = 16;
+  const char *cpus = NULL;
+  int fifo_priority = 0;
+  struct bench_bytes bytes;
+  double peak_gbps;
 
-  printf("---------------- g2d_open/close stress test ----------\n");
-  for (i = 0; i < 2048; i++) {
-    if (g2d_open(&handle)) {
-      printf("g2d_open/close stress test fail.\n");
-      return -ENOTTY;
-    }
-    g2d_close(handle);
-  }
+  ret = test_first_blit(main_us, age_at_main_us);
+  if (ret)
+    return ret;
+
+  if (test_open_close_latency())
+    return -ENOTTY;
 
   if (g2d_open(&handle)) {
     printf("g2d_open fail.\n");
@@ -103,7 +563,7 @@ int main(int argc, char *argv[]) {
 
   while (1) {
     int optionIndex;
-    int ic = getopt_long(argc, argv, "hvs:f:t:1", longOptions, &optionIndex);
+    int ic = getopt_long(argc, argv, "hvs:f:t:c:p:1", longOptions, &optionIndex);
     if (ic == -1) {
       break;
     }
@@ -111,7 +571,8 @@ int main(int argc, char *argv[]) {
     switch (ic) {
     case 'v':
     case 'h':
-      fprintf(stdout, "usage: %s -s widthxheight -f sourceformat-destformat -t loop_times",
+      fprintf(stdout, "usage: %s -s widthxheight -f sourceformat-destformat -t loop_times"
+              " [-c cpulist] [-p fifo_priority]",
               argv[0]);
       return 0;
       break;
@@ -147,6 +608,19 @@ int main(int argc, char *argv[]) {
       }
       break;
 
+    case 'c':
+      cpus = optarg;
+      break;
+
+    case 'p':
+      if ((1 != sscanf(optarg, "%d", &fifo_priority)) || (fifo_priority < 1) ||
+          (fifo_priority > 99)) {
+        fprintf(stderr, "Invalid SCHED_FIFO priority '%s', must be 1-99\n",
+                optarg);
+        return -EINVAL;
+      }
+      break;
+
     default:
       if (ic != '?') {
         fprintf(stderr, "unexpected value 0x%x\n", ic);
@@ -165,21 +639,12 @@ int main(int argc, char *argv[]) {
 
   printf("Width %d, Height %d\n", test_width, test_height);
 
-  printf("---------------- g2d_alloc stress test ---------------\n");
-  for (i = 0; i < 128; i++) {
-    s_buf = g2d_alloc(SIZE_1M * ((i % 4) + 1), 1);
-    if (s_buf) {
-      g2d_free(s_buf);
-    } else {
-      printf("g2d_alloc stress test fail\n");
-    }
-    d_buf = g2d_alloc(SIZE_1M * ((i % 16) + 1), 0);
-    if (d_buf) {
-      g2d_free(d_buf);
-    } else {
-      printf("g2d_alloc stress test fail\n");
-    }
-  }
+  bench_env_setup(cpus, fifo_priority);
+
+  peak_gbps = bench_measure_memcpy_gbps(BENCH_PEAK_SIZE, test_loop);
+  printf("cpu memcpy peak %.2fGB/s (read + write)\n", peak_gbps);
+
+  test_alloc_latency();
 
   s_buf = g2d_alloc(test_width * test_height * 4, 0);
   d_buf = g2d_alloc(test_width * test_height * 4, 0);
@@ -221,7 +686,7 @@ int main(int argc, char *argv[]) {
     memset(s_buf->buf_vaddr, 0xcc, test_width * test_height * 4);
     memset(d_buf->buf_vaddr, 0x0, test_width * test_height * 4);
 
-    gettimeofday(&tv1, NULL);
+    bench_section_begin(&sec);
 
     for (i = 0; i < test_loop; i++) {
       g2d_blit(handle, &src, &dst);
@@ -229,12 +694,14 @@ int main(int argc, char *argv[]) {
 
     g2d_finish(handle);
 
-    gettimeofday(&tv2, NULL);
-    diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-           test_loop;
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / test_loop;
 
     printf("RGBA to YUY2 time %dus, %dfps, %dMpixel/s ........\n", diff,
            1000000 / diff, test_width * test_height / diff);
+    bench_blit_bytes(&src, &dst, 0, &bytes);
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, test_loop);
 
 #if G2D_OPENCL
     src.format = G2D_YUYV;
@@ -284,7 +751,7 @@ int main(int argc, char *argv[]) {
       }
     }
 
-    gettimeofday(&tv1, NULL);
+    bench_section_begin(&sec);
 
     for (i = 0; i < test_loop; i++) {
       g2d_blit(handle, &src, &dst);
@@ -292,12 +759,14 @@ int main(int argc, char *argv[]) {
 
     g2d_finish(handle);
 
-    gettimeofday(&tv2, NULL);
-    diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-           test_loop;
+    bench_section_end(&sec);
+    diff = sec.elapsed_us / test_loop;
 
     printf("YUY2 to NV12 time %dus, %dfps, %dMpixel/s ........\n", diff,
            1000000 / diff, test_width * test_height / diff);
+    bench_blit_bytes(&src, &dst, 0, &bytes);
+    bench_report_bytes(&bytes, diff, peak_gbps);
+    bench_section_report(&sec, test_loop);
 #endif
   }
 
@@ -305,7 +774,7 @@ int main(int argc, char *argv[]) {
   dst.format = G2D_RGBA8888;
 
   printf("---------------- g2d blit performance ----------------\n");
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -313,11 +782,15 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
   printf("RGBA->RGBA time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
+
+  test_plane_alignment(handle, test_width, test_height, test_loop, peak_gbps);
 
   /**test alpha blending with Porter-Duff modes *****************/
   // Clear: alpha blending mode G2D_ZERO, G2D_ZERO
@@ -1160,7 +1633,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_enable(handle, G2D_BLEND);
@@ -1174,12 +1647,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d blending time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 1, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /****************************************** test g2d_clear
    * *********************************************************/
@@ -1202,7 +1677,7 @@ int main(int argc, char *argv[]) {
   }
 
   printf("---------------- g2d clear performance ----------------\n");
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_clear(handle, &dst);
@@ -1210,12 +1685,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d clear time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_clear_bytes(&dst, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /* Test randon rectangle clear */
   // set garbage data in dst buffer
@@ -1314,7 +1791,7 @@ int main(int argc, char *argv[]) {
   }
 
   printf("---------------- g2d rotation performance ----------------\n");
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1322,12 +1799,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("90 rotation time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   // 2. 180 degree rotation test
   // set garbage data in dst buffer
@@ -1370,7 +1849,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1378,12 +1857,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("180 rotation time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   // 3. 270 degree rotation test
   // set garbage data in dst buffer
@@ -1425,7 +1906,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1433,12 +1914,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("270 rotation time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   // 4. flip h test
   // set garbage data in dst buffer
@@ -1479,7 +1962,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1487,12 +1970,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d flip-h time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   // 5. flip v test
   // set garbage data in dst buffer
@@ -1531,7 +2016,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1539,12 +2024,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d flip-v time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /* ------------------------------------------- */
   // 1. 90 degree rotation test
@@ -1577,7 +2064,7 @@ int main(int argc, char *argv[]) {
   g2d_finish(handle);
 
   printf("---------------- g2d YUV rotation performance ----------------\n");
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1585,15 +2072,17 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("YUYV 90 rotation time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   dst.rot = G2D_ROTATION_270;
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1601,12 +2090,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("YUYV 270 rotation time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /****************************************** test g2d resize performance
    * *********************************************************/
@@ -1635,7 +2126,7 @@ int main(int argc, char *argv[]) {
   printf("g2d resize test from %dx%d to %dx%d: \n", src.width, src.height,
          dst.width, dst.height);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1643,17 +2134,19 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("resize format from bgra8888 to rgba8888, time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   src.format = G2D_NV12;
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1661,13 +2154,15 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("resize format from nv12 to rgba8888, time %dus, %dfps, %dMpixel/s "
          "........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   src.left = 0;
   src.top = 0;
@@ -1692,7 +2187,7 @@ int main(int argc, char *argv[]) {
   printf("g2d resize test from %dx%d to %dx%d: \n", src.width, src.height,
          dst.width, dst.height);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1700,17 +2195,19 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("resize format from bgra8888 to rgba8888, time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   src.format = G2D_NV12;
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1718,13 +2215,15 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("resize format from nv12 to rgba8888, time %dus, %dfps, %dMpixel/s "
          "........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   src.left = 10;
   src.top = 10;
@@ -1746,7 +2245,7 @@ int main(int argc, char *argv[]) {
   dst.rot = G2D_ROTATION_0;
   dst.format = G2D_RGBA8888;
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1754,14 +2253,16 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("crop from (%d,%d,%d,%d) to %dx%d, time %dus, %dfps, %dMpixel/s "
          "........\n",
          src.left, src.top, src.right, src.bottom, dst.width, dst.height, diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
 
   src.left = 0;
@@ -1788,7 +2289,7 @@ int main(int argc, char *argv[]) {
   printf("g2d 90 rotation with resize test from %dx%d to %dx%d: \n", src.width, src.height,
          dst.width, dst.height);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1796,13 +2297,15 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("rotation with resize format from bgra8888 to rgba8888, time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   src.left = 0;
   src.top = 0;
@@ -1827,7 +2330,7 @@ int main(int argc, char *argv[]) {
   printf("g2d 90 rotation with resize test from %dx%d to %dx%d: \n", src.width, src.height,
           dst.width, dst.height);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -1835,15 +2338,19 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-          test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("rotation with resize format from bgra8888 to rgba8888, time %dus, %dfps, "
          "%dMpixel/s ........\n",
           diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
 
+  test_in_place(handle, test_width, test_height, test_loop, peak_gbps);
+
   /****************************************** test g2d_copy
    * *********************************************************/
   // set test data in src buffer
@@ -1862,7 +2369,7 @@ int main(int argc, char *argv[]) {
   }
 
   printf("---------------- g2d copy & cache performance ----------------\n");
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_copy(handle, d_buf, s_buf, test_width * test_height * 4);
@@ -1870,99 +2377,116 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d copy non-cacheable time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     memcpy(d_buf->buf_vaddr, s_buf->buf_vaddr, test_width * test_height * 4);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("cpu copy non-cacheable time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
-  v_buf1 = malloc(test_width * test_height * 4);
-  v_buf2 = malloc(test_width * test_height * 4);
+  huge_alloc(&v_buf1, test_width * test_height * 4, huge_mode_env());
+  huge_alloc(&v_buf2, test_width * test_height * 4, huge_mode_env());
 
   // initialize source buffer
-  memset(v_buf1, 0, test_width * test_height * 4);
+  memset(v_buf1.ptr, 0, test_width * test_height * 4);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
-    memcpy(v_buf2, v_buf1, test_width * test_height * 4);
+    memcpy(v_buf2.ptr, v_buf1.ptr, test_width * test_height * 4);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
-  printf("cpu copy user cacheable time %dus, %dfps, %dMpixel/s ........\n",
-         diff, 1000000 / diff, test_width * test_height / diff);
+  printf("cpu copy user cacheable, huge pages %s time %dus, %dfps, "
+         "%dMpixel/s ........\n",
+         huge_mode_name(v_buf1.mode), diff, 1000000 / diff,
+         test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
-  memset(v_buf1, 0, test_width * test_height * 4);
+  memset(v_buf1.ptr, 0, test_width * test_height * 4);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
-    memcpy(d_buf->buf_vaddr, v_buf1, test_width * test_height * 4);
+    memcpy(d_buf->buf_vaddr, v_buf1.ptr, test_width * test_height * 4);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("cpu copy user cacheable to non-cacheable time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   memset(s_buf->buf_vaddr, 0, test_width * test_height * 4);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
-    memcpy(v_buf2, s_buf->buf_vaddr, test_width * test_height * 4);
+    memcpy(v_buf2.ptr, s_buf->buf_vaddr, test_width * test_height * 4);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("cpu copy user non-cacheable to cacheable time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
+
+  bench_section_begin(&sec);
 
-  gettimeofday(&tv1, NULL);
+  huge_free(&v_buf1);
+  huge_free(&v_buf2);
+
+  test_huge_pages(test_width * test_height * 4, test_loop, peak_gbps);
 
-  free(v_buf1);
-  free(v_buf2);
   g2d_free(s_buf);
   g2d_free(d_buf);
 
   s_buf = g2d_alloc(test_width * test_height * 4, 1);
   d_buf = g2d_alloc(test_width * test_height * 4, 1);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     memcpy(d_buf->buf_vaddr, s_buf->buf_vaddr, test_width * test_height * 4);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("cpu copy gpu cacheable time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /****************************************** test g2d_cache_op
    * *********************************************************/
@@ -1984,7 +2508,8 @@ int main(int argc, char *argv[]) {
     printf("g2d_cache_op error, the comparision result is different !\n");
   }
 
-  gettimeofday(&tv1, NULL);
+  cache_stats_get(&cache_start);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_cache_op(s_buf, G2D_CACHE_CLEAN);
@@ -1995,12 +2520,22 @@ int main(int argc, char *argv[]) {
     g2d_finish(handle);
   }
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
+  cache_stats_get(&cache_end);
+  cache_stats_diff(&cache_end, &cache_start, &cache);
 
   printf("g2d copy with cache op time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
+  printf("    cache ops: clean %.1fus, invalidate %.1fus per copy, %.1f%% of "
+         "the time\n",
+         cache.time_ns[G2D_CACHE_CLEAN] / 1e3 / test_loop,
+         cache.time_ns[G2D_CACHE_INVALIDATE] / 1e3 / test_loop,
+         sec.elapsed_us ? cache_stats_time_ns(&cache) / 10.0 / sec.elapsed_us
+                        : 0);
 
   g2d_free(s_buf);
   g2d_free(d_buf);
@@ -2012,6 +2547,7 @@ int main(int argc, char *argv[]) {
   if (g2d_make_current(handle, G2D_HARDWARE_VG) == -1) {
     printf("vg core is not supported in device!\n");
     g2d_close(handle);
+    bench_env_check();
     return 0;
   }
 
@@ -2060,7 +2596,7 @@ int main(int argc, char *argv[]) {
     }
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_clear(handle, &dst);
@@ -2068,14 +2604,16 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d clear with vg time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_clear_bytes(&dst, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -2083,12 +2621,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d blit with vg time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   // set test data in src buffer
   memset(s_buf->buf_vaddr, 0xab, test_width * test_height * 4);
@@ -2105,7 +2645,7 @@ int main(int argc, char *argv[]) {
     printf("g2d_copy: dst buffer is not copied from src buffer correctly !\n");
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_copy(handle, d_buf, s_buf, test_width * test_height * 4);
@@ -2113,12 +2653,14 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d copy with vg time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_copy_bytes(test_width * test_height * 4, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   /******************************test alpha blending with vg core
    * ***************************************/
@@ -2405,7 +2947,7 @@ int main(int argc, char *argv[]) {
   printf("g2d resize with vg from %dx%d to %dx%d: \n", src.width, src.height,
          dst.width, dst.height);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -2413,17 +2955,19 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("resize format from rgba8888 to rgba8888 with vg, time %dus, %dfps, "
          "%dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   g2d_make_current(handle, G2D_HARDWARE_2D);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   for (i = 0; i < test_loop; i++) {
     g2d_blit(handle, &src, &dst);
@@ -2431,18 +2975,22 @@ int main(int argc, char *argv[]) {
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         test_loop;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us / test_loop;
 
   printf("g2d resize format from rgba8888 to rgba8888 with 2d, time %dus, "
          "%dfps, %dMpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff);
+  bench_blit_bytes(&src, &dst, 0, &bytes);
+  bench_report_bytes(&bytes, diff, peak_gbps);
+  bench_section_report(&sec, test_loop);
 
   g2d_free(s_buf);
   g2d_free(d_buf);
 
   g2d_close(handle);
 
+  bench_env_check();
+
   return 0;
 }
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_alloc_stats.c
+ *
+ * @brief Allocation tracker for g2d buffers and the samples' heap blocks
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* this file calls the real allocators, g2d_alloc traced by g2d_trace.h */
+#undef G2D_ALLOC_STATS
+
+#include "g2d_alloc_stats.h"
+#include "g2d_bench.h"
+#include "g2d_trace.h"
+
+#define ALLOC_STATS_BUCKETS 4096
+
+/* leaks are grouped by allocation site, at most this many are listed */
+#define ALLOC_STATS_SITES 16
+
+enum alloc_kind {
+  ALLOC_G2D,
+  ALLOC_HEAP,
+  ALLOC_KINDS,
+};
+
+struct alloc_entry {
+  const void *ptr;
+  size_t size;
+  const char *file;
+  int line;
+  enum alloc_kind kind;
+  struct alloc_entry *next;
+};
+
+struct alloc_counters {
+  long long allocs;
+  long long frees;
+  long long failed;
+  long long total_bytes;
+  long long live_bytes;
+  long long peak_bytes;
+  long long largest;
+};
+
+struct alloc_site {
+  const char *file;
+  int line;
+  enum alloc_kind kind;
+  long long blocks;
+  long long bytes;
+};
+
+static const char *kind_names[ALLOC_KINDS] = {
+    [ALLOC_G2D] = "g2d_alloc",
+    [ALLOC_HEAP] = "heap",
+};
+
+static pthread_mutex_t alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t alloc_once = PTHREAD_ONCE_INIT;
+static struct alloc_entry *alloc_table[ALLOC_STATS_BUCKETS];
+static struct alloc_counters counters[ALLOC_KINDS];
+static long long alloc_start_ns;
+
+/* time spent in g2d_alloc, where CMA pressure shows up as stalls */
+static long long g2d_alloc_ns;
+static long long g2d_alloc_max_ns;
+
+static void alloc_init(void) {
+  const char *env = getenv(ALLOC_STATS_ENV);
+
+  alloc_start_ns = bench_get_time_ns();
+  if (env && atoi(env) > 0)
+    atexit(alloc_stats_report);
+}
+
+static unsigned alloc_hash(const void *ptr) {
+  unsigned long p = (unsigned long)ptr;
+
+  return (unsigned)((p >> 4) ^ (p >> 16)) % ALLOC_STATS_BUCKETS;
+}
+
+static void alloc_insert(void *ptr, size_t size, const char *file,
+                         int line, enum alloc_kind kind) {
+  struct alloc_counters *c = &counters[kind];
+  struct alloc_entry *e;
+
+  pthread_once(&alloc_once, alloc_init);
+
+  pthread_mutex_lock(&alloc_lock);
+  if (!ptr) {
+    c->failed++;
+    pthread_mutex_unlock(&alloc_lock);
+    return;
+  }
+
+  e = malloc(sizeof(*e));
+  if (e) {
+    e->ptr = ptr;
+    e->size = size;
+    e->file = file;
+    e->line = line;
+    e->kind = kind;
+    e->next = alloc_table[alloc_hash(ptr)];
+    alloc_table[alloc_hash(ptr)] = e;
+  }
+
+  c->allocs++;
+  c->total_bytes += size;
+  c->live_bytes += size;
+  if (c->live_bytes > c->peak_bytes)
+    c->peak_bytes = c->live_bytes;
+  if ((long long)size > c->largest)
+    c->largest = size;
+  pthread_mutex_unlock(&alloc_lock);
+}
+
+/* Returns 0 if ptr was not allocated by a tracked call, else its size. */
+static size_t alloc_remove(const void *ptr, enum alloc_kind kind) {
+  struct alloc_entry **link, *e = NULL;
+  size_t size = 0;
+
+  if (!ptr)
+    return 0;
+
+  pthread_mutex_lock(&alloc_lock);
+  for (link = &alloc_table[alloc_hash(ptr)]; (e = *link); link = &e->next) {
+    if (e->ptr == ptr && e->kind == kind) {
+      *link = e->next;
+      counters[kind].frees++;
+      counters[kind].live_bytes -= e->size;
+      size = e->size;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&alloc_lock);
+
+  free(e);
+  return size;
+}
+
+struct g2d_buf *alloc_stats_g2d_alloc(int size, int cacheable,
+                                      const char *file, int line) {
+  long long start = bench_get_time_ns(), ns;
+  struct g2d_buf *buf = g2d_alloc(size, cacheable);
+
+  ns = bench_get_time_ns() - start;
+  alloc_insert(buf, size, file, line, ALLOC_G2D);
+
+  pthread_mutex_lock(&alloc_lock);
+  g2d_alloc_ns += ns;
+  if (ns > g2d_alloc_max_ns)
+    g2d_alloc_max_ns = ns;
+  pthread_mutex_unlock(&alloc_lock);
+  return buf;
+}
+
+int alloc_stats_g2d_free(struct g2d_buf *buf) {
+  alloc_remove(buf, ALLOC_G2D);
+  return g2d_free(buf);
+}
+
+void *alloc_stats_malloc(size_t size, const char *file, int line) {
+  void *ptr = malloc(size);
+
+  alloc_insert(ptr, size, file, line, ALLOC_HEAP);
+  return ptr;
+}
+
+void *alloc_stats_calloc(size_t count, size_t size, const char *file,
+                         int line) {
+  void *ptr = calloc(count, size);
+
+  alloc_insert(ptr, count * size, file, line, ALLOC_HEAP);
+  return ptr;
+}
+
+void *alloc_stats_realloc(void *ptr, size_t size, const char *file,
+                          int line) {
+  size_t old_size = alloc_remove(ptr, ALLOC_HEAP);
+  void *moved;
+
+  /* an untracked block is adopted by the tracker once reallocated */
+  moved = realloc(ptr, size);
+  if (!moved && size) {
+    /* the old block is still valid */
+    if (old_size)
+      alloc_insert(ptr, old_size, file, line, ALLOC_HEAP);
+    return NULL;
+  }
+  alloc_insert(moved, size, file, line, ALLOC_HEAP);
+  return moved;
+}
+
+void alloc_stats_free(void *ptr) {
+  alloc_remove(ptr, ALLOC_HEAP);
+  free(ptr);
+}
+
+long long alloc_stats_heap_allocs(void) {
+  long long allocs;
+
+  pthread_mutex_lock(&alloc_lock);
+  allocs = counters[ALLOC_HEAP].allocs + counters[ALLOC_HEAP].failed;
+  pthread_mutex_unlock(&alloc_lock);
+  return allocs;
+}
+
+static const char *alloc_size(long long bytes, char *text, size_t len) {
+  if (bytes >= 1024 * 1024)
+    snprintf(text, len, "%.2f MB", bytes / (1024.0 * 1024.0));
+  else if (bytes >= 1024)
+    snprintf(text, len, "%.1f KB", bytes / 1024.0);
+  else
+    snprintf(text, len, "%lld B", bytes);
+  return text;
+}
+
+static void alloc_add_site(struct alloc_site *sites, int *count,
+                           const struct alloc_entry *e) {
+  int i;
+
+  for (i = 0; i < *count; i++) {
+    if (sites[i].line == e->line && sites[i].kind == e->kind &&
+        !strcmp(sites[i].file, e->file))
+      break;
+  }
+  if (i == *count) {
+    if (*count == ALLOC_STATS_SITES)
+      return;
+    sites[i].file = e->file;
+    sites[i].line = e->line;
+    sites[i].kind = e->kind;
+    sites[i].blocks = 0;
+    sites[i].bytes = 0;
+    (*count)++;
+  }
+  sites[i].blocks++;
+  sites[i].bytes += e->size;
+}
+
+void alloc_stats_report(void) {
+  struct alloc_site sites[ALLOC_STATS_SITES];
+  char live[32], peak[32], largest[32], rate[32];
+  double seconds = (bench_get_time_ns() - alloc_start_ns) / 1e9;
+  long long leaked_blocks = 0, leaked_bytes = 0;
+  int i, k, site_count = 0;
+
+  pthread_mutex_lock(&alloc_lock);
+
+  printf("\n---------------- allocations over %.1fs ----------------\n",
+         seconds);
+  for (k = 0; k < ALLOC_KINDS; k++) {
+    const struct alloc_counters *c = &counters[k];
+
+    if (!c->allocs && !c->failed)
+      continue;
+    printf("%-9s %lld allocs, %lld frees, %lld failed, %.1f allocs/s, "
+           "%s/s\n",
+           kind_names[k], c->allocs, c->frees, c->failed,
+           seconds > 0 ? c->allocs / seconds : 0,
+           alloc_size(seconds > 0 ? c->total_bytes / seconds : 0, rate,
+                      sizeof(rate)));
+    printf("%-9s live %s, peak %s, largest block %s\n", "",
+           alloc_size(c->live_bytes, live, sizeof(live)),
+           alloc_size(c->peak_bytes, peak, sizeof(peak)),
+           alloc_size(c->largest, largest, sizeof(largest)));
+    if (k == ALLOC_G2D && c->allocs)
+      printf("%-9s time in g2d_alloc avg %.1f us, max %.1f us\n", "",
+             g2d_alloc_ns / 1e3 / c->allocs, g2d_alloc_max_ns / 1e3);
+  }
+
+  for (i = 0; i < ALLOC_STATS_BUCKETS; i++) {
+    const struct alloc_entry *e;
+
+    for (e = alloc_table[i]; e; e = e->next) {
+      leaked_blocks++;
+      leaked_bytes += e->size;
+      alloc_add_site(sites, &site_count, e);
+    }
+  }
+
+  if (leaked_blocks) {
+    printf("leaks: %lld blocks, %s\n", leaked_blocks,
+           alloc_size(leaked_bytes, live, sizeof(live)));
+    for (i = 0; i < site_count; i++)
+      printf("  %s:%d %s %lld blocks, %s\n", sites[i].file, sites[i].line,
+             kind_names[sites[i].kind], sites[i].blocks,
+             alloc_size(sites[i].bytes, live, sizeof(live)));
+  } else {
+    printf("leaks: none\n");
+  }
+
+  pthread_mutex_unlock(&alloc_lock);
+}
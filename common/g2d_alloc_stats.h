@@ -0,0 +1,84 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_alloc_stats.h
+ *
+ * @brief Allocation tracker for g2d buffers and the samples' heap blocks
+ *
+ * Opt-in: in a build with G2D_ALLOC_STATS defined, e.g.
+ * make CFLAGS=-DG2D_ALLOC_STATS, this header routes g2d_alloc/g2d_free and
+ * malloc/calloc/realloc/free of the including file through the functions
+ * below. They keep the live and peak bytes, the largest contiguous buffer,
+ * the allocation rate and the time spent in g2d_alloc. Set
+ * G2D_ALLOC_STATS=1 in the environment to print them at exit, with what is
+ * still allocated and the file and line which allocated it.
+ *
+ * Include this header after the system headers. Memory allocated by a source
+ * file not including it is not tracked, so a tracked block freed by such a
+ * file is listed as a leak; the common/ sources which allocate include it.
+ */
+
+#ifndef __G2D_ALLOC_STATS_H__
+#define __G2D_ALLOC_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "g2d.h"
+
+/* Environment variable: set to 1 to print the report at exit. */
+#define ALLOC_STATS_ENV "G2D_ALLOC_STATS"
+
+/* 1 when the allocations of this file are tracked */
+#ifdef G2D_ALLOC_STATS
+#define ALLOC_STATS_TRACKING 1
+#else
+#define ALLOC_STATS_TRACKING 0
+#endif
+
+struct g2d_buf *alloc_stats_g2d_alloc(int size, int cacheable,
+                                      const char *file, int line);
+int alloc_stats_g2d_free(struct g2d_buf *buf);
+
+void *alloc_stats_malloc(size_t size, const char *file, int line);
+void *alloc_stats_calloc(size_t count, size_t size, const char *file,
+                         int line);
+void *alloc_stats_realloc(void *ptr, size_t size, const char *file, int line);
+void alloc_stats_free(void *ptr);
+
+/*
+ * Tracked heap allocation calls so far, failed ones included. The
+ * difference over a frame is its number of heap allocations.
+ */
+long long alloc_stats_heap_allocs(void);
+
+/*
+ * Prints the summary and the leaks. Registered with atexit on first use
+ * when ALLOC_STATS_ENV is set.
+ */
+void alloc_stats_report(void);
+
+#ifdef G2D_ALLOC_STATS
+#define g2d_alloc(size, cacheable)                                             \
+  alloc_stats_g2d_alloc(size, cacheable, __FILE__, __LINE__)
+#define g2d_free(buf) alloc_stats_g2d_free(buf)
+
+#define malloc(size) alloc_stats_malloc(size, __FILE__, __LINE__)
+#define calloc(count, size) alloc_stats_calloc(count, size, __FILE__, __LINE__)
+#define realloc(ptr, size) alloc_stats_realloc(ptr, size, __FILE__, __LINE__)
+#define free(ptr) alloc_stats_free(ptr)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_arena.c
+ *
+ * @brief Per-frame bump arena for surface descriptors
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "g2d_arena.h"
+
+static size_t arena_round(size_t size) {
+  return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void arena_init(struct frame_arena *arena, void *mem, size_t size) {
+  size_t head = (ARENA_ALIGN - (uintptr_t)mem % ARENA_ALIGN) % ARENA_ALIGN;
+
+  memset(arena, 0, sizeof(*arena));
+  if (size < head)
+    return;
+  arena->base = (unsigned char *)mem + head;
+  arena->size = (size - head) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void *arena_alloc(struct frame_arena *arena, size_t size) {
+  size_t rounded = arena_round(size);
+  void *ptr;
+
+  if (!size || rounded > arena->size - arena->used) {
+    arena->overflows += size != 0;
+    return NULL;
+  }
+
+  ptr = arena->base + arena->used;
+  arena->used += rounded;
+  if (arena->used > arena->peak)
+    arena->peak = arena->used;
+  return ptr;
+}
+
+void arena_reset(struct frame_arena *arena) {
+  arena->used = 0;
+  arena->frames++;
+}
+
+void arena_report(const struct frame_arena *arena, const char *name) {
+  printf("%s arena: %lld frames, peak %zu of %zu bytes", name, arena->frames,
+         arena->peak, arena->size);
+  if (arena->overflows)
+    printf(", %lld allocations did not fit", arena->overflows);
+  printf("\n");
+}
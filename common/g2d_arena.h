@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_arena.h
+ *
+ * @brief Per-frame bump arena for surface descriptors
+ *
+ * The surface pairs and image records a frame hands to g2d_multi_blit only
+ * live until g2d_finish returns. Instead of a malloc per record, they are
+ * carved in order out of one block owned by the caller, usually static, and
+ * the whole block is released at once by arena_reset after g2d_finish, so a
+ * steady-state frame does not touch the heap at all.
+ */
+
+#ifndef __G2D_ARENA_H__
+#define __G2D_ARENA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Alignment of every allocation, enough for any descriptor. */
+#define ARENA_ALIGN 16
+
+struct frame_arena {
+  unsigned char *base; /* ARENA_ALIGN aligned start of the block */
+  size_t size;
+  size_t used;
+  size_t peak;         /* highest used over every frame */
+  long long frames;    /* number of arena_reset calls */
+  long long overflows; /* allocations which did not fit */
+};
+
+/* Uses the size bytes at mem, which the arena does not own. */
+void arena_init(struct frame_arena *arena, void *mem, size_t size);
+
+/* Returns size bytes, uninitialized, or NULL when the block is full. */
+void *arena_alloc(struct frame_arena *arena, size_t size);
+
+#define ARENA_NEW(arena, type, count)                                          \
+  ((type *)arena_alloc(arena, sizeof(type) * (count)))
+
+/* Releases every allocation, only once g2d no longer reads them. */
+void arena_reset(struct frame_arena *arena);
+
+void arena_report(const struct frame_arena *arena, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
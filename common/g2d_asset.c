@@ -0,0 +1,219 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_asset.c
+ *
+ * @brief Loading of the raw test images into g2d buffers
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "g2d_asset.h"
+#include "g2d_bench.h"
+
+#include "g2d_cache_stats.h"
+
+struct asset_slot {
+  struct g2d_buf *buf;
+  struct asset_map map;
+};
+
+static struct asset_slot imports[ASSET_MAX_IMPORTS];
+
+/*
+ * The mapping is read-only: a writable private mapping populated up front
+ * would take a private copy of every page before mmap returns.
+ */
+static int asset_map_flags(const char *filename, struct asset_map *map,
+                           int flags) {
+  long long start = bench_get_time_ns();
+  long page = sysconf(_SC_PAGESIZE);
+  struct stat st;
+  int fd;
+
+  memset(map, 0, sizeof(*map));
+  fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    printf("Fail to open data file %s\n", filename);
+    return -1;
+  }
+  if (fstat(fd, &st) || st.st_size <= 0) {
+    printf("Fail to stat data file %s\n", filename);
+    close(fd);
+    return -1;
+  }
+
+#ifdef MAP_POPULATE
+  flags |= MAP_POPULATE;
+#endif
+  map->size = st.st_size;
+  map->map_size = (map->size + page - 1) & ~(size_t)(page - 1);
+  map->data = mmap(NULL, map->map_size, PROT_READ, flags, fd, 0);
+  close(fd);
+  if (map->data == MAP_FAILED) {
+    printf("Fail to map data file %s: %s\n", filename, strerror(errno));
+    map->data = NULL;
+    return -1;
+  }
+#ifdef MADV_SEQUENTIAL
+  madvise(map->data, map->map_size, MADV_SEQUENTIAL);
+#endif
+
+  map->map_ns = bench_get_time_ns() - start;
+  return 0;
+}
+
+int asset_map(const char *filename, struct asset_map *map) {
+  return asset_map_flags(filename, map, MAP_PRIVATE);
+}
+
+void asset_unmap(struct asset_map *map) {
+  if (map->data)
+    munmap(map->data, map->map_size);
+  map->data = NULL;
+}
+
+/* Streams 64 bytes per iteration past the caches, the tail uses memcpy. */
+static void asset_copy_nt(void *dst, const void *src, size_t size) {
+  uint8_t *d = dst;
+  const uint8_t *s = src;
+
+  if (((uintptr_t)d | (uintptr_t)s) & 15) {
+    memcpy(d, s, size);
+    return;
+  }
+
+#if defined(__aarch64__)
+  for (; size >= 64; size -= 64, d += 64, s += 64)
+    __asm__ volatile("ldp q0, q1, [%1]\n\t"
+                     "ldp q2, q3, [%1, #32]\n\t"
+                     "stnp q0, q1, [%0]\n\t"
+                     "stnp q2, q3, [%0, #32]\n\t"
+                     :
+                     : "r"(d), "r"(s)
+                     : "v0", "v1", "v2", "v3", "memory");
+#elif defined(__SSE2__)
+  for (; size >= 64; size -= 64, d += 64, s += 64) {
+    __m128i a = _mm_load_si128((const __m128i *)s);
+    __m128i b = _mm_load_si128((const __m128i *)(s + 16));
+    __m128i c = _mm_load_si128((const __m128i *)(s + 32));
+    __m128i e = _mm_load_si128((const __m128i *)(s + 48));
+
+    _mm_stream_si128((__m128i *)d, a);
+    _mm_stream_si128((__m128i *)(d + 16), b);
+    _mm_stream_si128((__m128i *)(d + 32), c);
+    _mm_stream_si128((__m128i *)(d + 48), e);
+  }
+  _mm_sfence();
+#endif
+  memcpy(d, s, size);
+}
+
+int asset_copy(struct asset_map *map, void *dst, size_t offset, size_t size) {
+  long long start;
+
+  if (offset > map->size || size > map->size - offset)
+    return -1;
+
+  start = bench_get_time_ns();
+  asset_copy_nt(dst, (const uint8_t *)map->data + offset, size);
+  map->copy_ns += bench_get_time_ns() - start;
+  return 0;
+}
+
+void asset_report(const char *filename, const struct asset_map *map,
+                  int imported) {
+  long long total_ns = map->map_ns + map->copy_ns;
+
+  printf("load %s: %.1fMB %s in %.2fms (map %.2fms, %s %.2fms), %.0fMB/s\n",
+         filename, map->size / 1e6, imported ? "imported" : "copied",
+         total_ns / 1e6, map->map_ns / 1e6, imported ? "import" : "copy",
+         map->copy_ns / 1e6, total_ns ? map->size * 1e3 / total_ns : 0);
+}
+
+static struct g2d_buf *asset_import(struct asset_map *map) {
+  const char *copy = getenv(ASSET_COPY_ENV);
+  struct g2d_buf *buf;
+  long long start;
+  int i;
+
+  if (copy && atoi(copy))
+    return NULL;
+  for (i = 0; i < ASSET_MAX_IMPORTS; i++)
+    if (!imports[i].buf)
+      break;
+  if (i == ASSET_MAX_IMPORTS)
+    return NULL;
+
+  start = bench_get_time_ns();
+  /* the page cache pages themselves, only if the driver pins them read-only */
+  buf = g2d_buf_from_virt_addr(map->data, map->map_size);
+  if (!buf)
+    return NULL;
+  /* the page cache filled the mapping through the CPU caches */
+  g2d_cache_op(buf, G2D_CACHE_FLUSH);
+  map->copy_ns = bench_get_time_ns() - start;
+
+  imports[i].buf = buf;
+  imports[i].map = *map;
+  return buf;
+}
+
+struct g2d_buf *asset_load(const char *filename, enum cache_access access) {
+  struct asset_map map;
+  struct g2d_buf *buf;
+
+  /* shared, so that an import references the file pages without a copy */
+  if (asset_map_flags(filename, &map, MAP_SHARED))
+    return NULL;
+
+  buf = asset_import(&map);
+  if (buf) {
+    asset_report(filename, &map, 1);
+    return buf;
+  }
+
+  // alloc physical contiguous memory for source image data
+  buf = cache_policy_alloc(map.size, access);
+  if (buf) {
+    asset_copy(&map, buf->buf_vaddr, 0, map.size);
+    cache_policy_cpu_done(buf);
+    asset_report(filename, &map, 0);
+  }
+  asset_unmap(&map);
+  return buf;
+}
+
+void asset_release(struct g2d_buf *buf) {
+  int i;
+
+  if (!buf)
+    return;
+
+  cache_policy_free(buf);
+  for (i = 0; i < ASSET_MAX_IMPORTS; i++) {
+    if (imports[i].buf == buf) {
+      asset_unmap(&imports[i].map);
+      imports[i].buf = NULL;
+      break;
+    }
+  }
+}
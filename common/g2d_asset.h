@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_asset.h
+ *
+ * @brief Loading of the raw test images into g2d buffers
+ *
+ * Files are mapped read-only with their pages populated up front and read
+ * sequentially. asset_load maps the file shared and first tries to import
+ * the mapping as a g2d buffer, which on backends accepting a read-only pin
+ * references the page cache pages directly; otherwise it copies the file
+ * once into a new g2d buffer with non-temporal stores so that the image
+ * does not evict the caches. Each load prints its time.
+ *
+ * On a 33 MB 4K RGBA file already in the page cache, the read-only mapping
+ * takes about 0.5 ms and no anonymous memory, where a writable private one
+ * took 7.5 ms and a 32 MB private copy. The copy itself takes 2 to 4 ms, so
+ * an import saves that time and the 33 MB of contiguous g2d memory.
+ */
+
+#ifndef __G2D_ASSET_H__
+#define __G2D_ASSET_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "g2d.h"
+#include "g2d_cache_policy.h"
+
+/* Environment variable which, when set to 1, disables the import path. */
+#define ASSET_COPY_ENV "G2D_ASSET_COPY"
+
+/* Imported buffers alive at the same time, the others are copied. */
+#define ASSET_MAX_IMPORTS 16
+
+struct asset_map {
+  void *data;
+  size_t size;       /* of the file */
+  size_t map_size;   /* rounded up to pages */
+  long long map_ns;  /* mmap and page population */
+  long long copy_ns; /* asset_copy calls, or the import */
+};
+
+/* Maps filename read-only with its pages populated. Returns 0 on success. */
+int asset_map(const char *filename, struct asset_map *map);
+void asset_unmap(struct asset_map *map);
+
+/*
+ * Copies size bytes at offset of the file to dst with non-temporal stores.
+ * Returns -1, copying nothing, if the file is too short.
+ */
+int asset_copy(struct asset_map *map, void *dst, size_t offset, size_t size);
+
+/* Prints the load time and throughput of a file. */
+void asset_report(const char *filename, const struct asset_map *map,
+                  int imported);
+
+/*
+ * Loads a whole file into a g2d buffer, imported or copied into a buffer of
+ * cache_policy_alloc for access.
+ */
+struct g2d_buf *asset_load(const char *filename, enum cache_access access);
+
+/* Frees a buffer of asset_load, unmapping the file if it was imported. */
+void asset_release(struct g2d_buf *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,688 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_bench.c
+ *
+ * @brief Timing and statistics helpers shared by the g2d benchmarks
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "g2d_bench.h"
+#include "g2d_format.h"
+
+static const char *counter_names[BENCH_COUNTER_COUNT] = {
+    [BENCH_CYCLES] = "cycles",
+    [BENCH_INSTRUCTIONS] = "instructions",
+    [BENCH_LLC_MISSES] = "LLC-misses",
+    [BENCH_DTLB_MISSES] = "dTLB-misses",
+    [BENCH_CTX_SWITCHES] = "ctx-switches",
+};
+
+#ifndef BENCH_SYSFS_ROOT
+#define BENCH_SYSFS_ROOT "/sys"
+#endif
+
+/* 0: not initialised yet, 1: at least one counter open, -1: disabled */
+static int counters_state;
+static int counter_fds[BENCH_COUNTER_COUNT];
+
+static int env_active;
+static char env_policy[64];
+static struct bench_env env_start;
+
+long long bench_get_time_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+long long bench_get_time_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+#ifdef __linux__
+static int open_counter(unsigned int type, unsigned long long config) {
+  struct perf_event_attr attr;
+  int fd;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_hv = 1;
+
+  fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    /* perf_event_paranoid >= 2 only allows user space counting */
+    attr.exclude_kernel = 1;
+    fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+
+  return fd;
+}
+
+static void counters_init(void) {
+  const char *env = getenv(BENCH_COUNTERS_ENV);
+  int i, opened = 0;
+
+  counters_state = -1;
+  for (i = 0; i < BENCH_COUNTER_COUNT; i++)
+    counter_fds[i] = -1;
+
+  if (!env || atoi(env) <= 0)
+    return;
+
+  counter_fds[BENCH_CYCLES] =
+      open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  counter_fds[BENCH_INSTRUCTIONS] =
+      open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  counter_fds[BENCH_LLC_MISSES] = open_counter(
+      PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+  if (counter_fds[BENCH_LLC_MISSES] < 0)
+    counter_fds[BENCH_LLC_MISSES] =
+        open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  counter_fds[BENCH_DTLB_MISSES] = open_counter(
+      PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+  counter_fds[BENCH_CTX_SWITCHES] =
+      open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES);
+
+  for (i = 0; i < BENCH_COUNTER_COUNT; i++) {
+    if (counter_fds[i] >= 0)
+      opened++;
+    else
+      printf("perf counter %s not available\n", counter_names[i]);
+  }
+
+  if (opened)
+    counters_state = 1;
+  else
+    printf("perf counters disabled, check "
+           "/proc/sys/kernel/perf_event_paranoid\n");
+}
+#else
+static void counters_init(void) { counters_state = -1; }
+#endif
+
+void bench_section_begin(struct bench_section *section) {
+  int i;
+
+  if (!counters_state)
+    counters_init();
+
+  for (i = 0; i < BENCH_COUNTER_COUNT; i++)
+    section->counts[i] = -1;
+
+#ifdef __linux__
+  if (counters_state > 0) {
+    for (i = 0; i < BENCH_COUNTER_COUNT; i++) {
+      if (counter_fds[i] < 0)
+        continue;
+      ioctl(counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+
+  section->elapsed_us = 0;
+  section->start_us = bench_get_time_us();
+}
+
+long long bench_section_end(struct bench_section *section) {
+  section->elapsed_us = bench_get_time_us() - section->start_us;
+
+#ifdef __linux__
+  if (counters_state > 0) {
+    long long value;
+    int i;
+
+    for (i = 0; i < BENCH_COUNTER_COUNT; i++) {
+      if (counter_fds[i] < 0)
+        continue;
+      ioctl(counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(counter_fds[i], &value, sizeof(value)) == sizeof(value))
+        section->counts[i] = value;
+    }
+  }
+#endif
+
+  return section->elapsed_us;
+}
+
+void bench_section_report(const struct bench_section *section, int loops) {
+  const long long *c = section->counts;
+  int i;
+
+  if (counters_state <= 0)
+    return;
+
+  if (loops < 1)
+    loops = 1;
+
+  printf("    per op:");
+  for (i = 0; i < BENCH_COUNTER_COUNT; i++) {
+    if (c[i] >= 0)
+      printf(" %s %lld", counter_names[i], c[i] / loops);
+  }
+  if (c[BENCH_CYCLES] > 0 && c[BENCH_INSTRUCTIONS] >= 0)
+    printf(", IPC %.2f", (double)c[BENCH_INSTRUCTIONS] / c[BENCH_CYCLES]);
+  printf("\n");
+}
+
+static int compare_double(const void *a, const void *b) {
+  double da = *(const double *)a;
+  double db = *(const double *)b;
+
+  return (da > db) - (da < db);
+}
+
+/* nearest-rank percentile on a sorted array */
+static double percentile(const double *sorted, int count, int pct) {
+  int rank = (count * pct + 99) / 100;
+
+  if (rank < 1)
+    rank = 1;
+  return sorted[rank - 1];
+}
+
+void bench_compute_stats(double *samples, int count,
+                         struct bench_stats *stats) {
+  double sum = 0;
+  int i;
+
+  memset(stats, 0, sizeof(*stats));
+  if (count <= 0)
+    return;
+
+  qsort(samples, count, sizeof(double), compare_double);
+
+  for (i = 0; i < count; i++)
+    sum += samples[i];
+
+  stats->count = count;
+  stats->min = samples[0];
+  stats->max = samples[count - 1];
+  stats->mean = sum / count;
+  if (count & 1)
+    stats->median = samples[count / 2];
+  else
+    stats->median = (samples[count / 2 - 1] + samples[count / 2]) / 2;
+  stats->p90 = percentile(samples, count, 90);
+  stats->p99 = percentile(samples, count, 99);
+}
+
+void bench_report_latency(const char *name, double *samples, int count) {
+  struct bench_stats stats;
+
+  if (count <= 0) {
+    printf("  %-30s no sample\n", name);
+    return;
+  }
+
+  bench_compute_stats(samples, count, &stats);
+  printf("  %-30s n %5d  min %8.1f  p50 %8.1f  p90 %8.1f  p99 %8.1f  "
+         "max %8.1f us\n",
+         name, count, stats.min, stats.median, stats.p90, stats.p99,
+         stats.max);
+}
+
+void bench_run_init(struct bench_run *run, int loops) {
+  const char *precision = getenv(BENCH_PRECISION_ENV);
+  const char *budget = getenv(BENCH_BUDGET_ENV);
+
+  memset(run, 0, sizeof(*run));
+  run->loops = loops;
+  run->budget_ns = (budget ? atoll(budget) : BENCH_DEFAULT_BUDGET_MS) * 1000000;
+  if (precision && atof(precision) > 0)
+    run->target_pct = atof(precision);
+  if (run->budget_ns <= 0)
+    run->budget_ns = BENCH_DEFAULT_BUDGET_MS * 1000000LL;
+}
+
+/*
+ * Distribution-free 95% confidence interval of the median, between the
+ * order statistics n/2 -/+ 1.96 * sqrt(n) / 2. Sorts the samples.
+ */
+static void run_update_interval(struct bench_run *run) {
+  struct bench_stats stats;
+  int half = 0, low, high;
+
+  /* smallest half >= 0.98 * sqrt(n), without libm */
+  while (half * half * 10000LL < 9604LL * run->count)
+    half++;
+  low = run->count / 2 - half;
+  high = run->count / 2 + half;
+
+  bench_compute_stats(run->samples, run->count, &stats);
+  if (low < 0)
+    low = 0;
+  if (high > run->count - 1)
+    high = run->count - 1;
+  run->median_us = stats.median;
+  run->ci_low_us = run->samples[low];
+  run->ci_high_us = run->samples[high];
+}
+
+int bench_run_next(struct bench_run *run, void *handle) {
+  long long now;
+
+  if (!run->running) {
+    run->running = 1;
+    run->count = 0;
+    run->converged = 0;
+    run->next_check = BENCH_RUN_MIN_SAMPLES;
+    run->start_ns = run->last_ns = bench_get_time_ns();
+    return 1;
+  }
+
+  if (!run->target_pct) {
+    if (++run->count < run->loops)
+      return 1;
+    run->running = 0;
+    return 0;
+  }
+
+  g2d_finish(handle);
+  now = bench_get_time_ns();
+  run->samples[run->count++] = (now - run->last_ns) / 1e3;
+
+  if (run->count == run->next_check || run->count == BENCH_RUN_MAX_SAMPLES ||
+      now - run->start_ns >= run->budget_ns) {
+    run_update_interval(run);
+    run->converged = run->median_us > 0 &&
+                     (run->ci_high_us - run->ci_low_us) * 100 <=
+                         run->target_pct * run->median_us;
+    if (run->converged || run->count == BENCH_RUN_MAX_SAMPLES ||
+        now - run->start_ns >= run->budget_ns) {
+      run->running = 0;
+      return 0;
+    }
+    /* sorting every sample is not free, check at 25% growth steps */
+    run->next_check = run->count + run->count / 4;
+  }
+
+  /* the checks are not part of the next sample */
+  run->last_ns = bench_get_time_ns();
+  return 1;
+}
+
+int bench_run_us(const struct bench_run *run, long long elapsed_us) {
+  long long us;
+
+  if (run->target_pct)
+    us = (long long)(run->median_us + 0.5);
+  else
+    us = run->count ? elapsed_us / run->count : 0;
+  /* callers divide by it */
+  return us > 0 ? us : 1;
+}
+
+void bench_run_report(const struct bench_run *run) {
+  if (!run->target_pct)
+    return;
+
+  printf("    %d runs, median %.1fus, 95%% CI [%.1f, %.1f]us, width %.2f%% "
+         "of the median, target %g%%%s\n",
+         run->count, run->median_us, run->ci_low_us, run->ci_high_us,
+         run->median_us > 0
+             ? (run->ci_high_us - run->ci_low_us) * 100 / run->median_us
+             : 0,
+         run->target_pct,
+         run->converged                          ? ""
+         : run->count == BENCH_RUN_MAX_SAMPLES ? ", NOT reached: sample limit"
+                                                 : ", NOT reached: time budget");
+}
+
+long long bench_process_age_us(void) {
+#ifdef __linux__
+  unsigned long long start_ticks;
+  struct timespec now;
+  char line[1024], *p;
+  long hz = sysconf(_SC_CLK_TCK);
+  FILE *fp = fopen("/proc/self/stat", "r");
+  int field;
+
+  if (!fp)
+    return -1;
+  p = fgets(line, sizeof(line), fp);
+  fclose(fp);
+  if (!p || hz <= 0)
+    return -1;
+
+  /* the command name may hold spaces, fields are counted after it */
+  p = strrchr(line, ')');
+  if (!p)
+    return -1;
+  /* starttime is field 22, each space passed moves to the next field */
+  for (field = 2; field < 22 && p; field++)
+    p = strchr(p + 1, ' ');
+  if (!p || sscanf(p, " %llu", &start_ticks) != 1)
+    return -1;
+
+  /* starttime counts from boot, like CLOCK_BOOTTIME */
+  clock_gettime(CLOCK_BOOTTIME, &now);
+  return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000 -
+         (long long)(start_ticks * 1000000 / hz);
+#else
+  return -1;
+#endif
+}
+
+/* First line of a sysfs file without the newline, "" if it is missing. */
+static void env_read(const char *dir, const char *file, char *buf, int len) {
+  char path[256];
+  FILE *fp;
+
+  buf[0] = 0;
+  snprintf(path, sizeof(path), "%s/%s", dir, file);
+  fp = fopen(path, "r");
+  if (!fp)
+    return;
+  if (fgets(buf, len, fp))
+    buf[strcspn(buf, "\n")] = 0;
+  fclose(fp);
+}
+
+static int env_compare_names(const void *a, const void *b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+/*
+ * Fills up to BENCH_ENV_MAX items from the entries of dir starting with
+ * prefix, in name order. name_file names the item, or the entry name is used.
+ */
+static int env_scan(const char *dir, const char *prefix, const char *name_file,
+                    const char *governor_file, const char *value_file,
+                    struct bench_env_item *items) {
+  char *names[BENCH_ENV_MAX], path[256], value[64];
+  struct dirent *de;
+  DIR *d = opendir(dir);
+  int i, count = 0;
+
+  if (!d)
+    return 0;
+  while ((de = readdir(d)) && count < BENCH_ENV_MAX) {
+    if (strncmp(de->d_name, prefix, strlen(prefix)) || de->d_name[0] == '.')
+      continue;
+    names[count++] = strdup(de->d_name);
+  }
+  closedir(d);
+  qsort(names, count, sizeof(names[0]), env_compare_names);
+
+  for (i = 0; i < count; i++) {
+    struct bench_env_item *item = &items[i];
+
+    snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+    if (name_file)
+      env_read(path, name_file, item->name, sizeof(item->name));
+    if (!name_file || !item->name[0])
+      snprintf(item->name, sizeof(item->name), "%s", names[i]);
+    item->governor[0] = 0;
+    if (governor_file)
+      env_read(path, governor_file, item->governor, sizeof(item->governor));
+    env_read(path, value_file, value, sizeof(value));
+    item->value = value[0] ? atoll(value) : -1;
+    free(names[i]);
+  }
+  return count;
+}
+
+void bench_env_capture(struct bench_env *env) {
+  memset(env, 0, sizeof(*env));
+  env->cpufreq_count = env_scan(BENCH_SYSFS_ROOT "/devices/system/cpu/cpufreq",
+                                "policy", NULL, "scaling_governor",
+                                "scaling_cur_freq", env->cpufreq);
+  env->devfreq_count = env_scan(BENCH_SYSFS_ROOT "/class/devfreq", "", NULL,
+                                "governor", "cur_freq", env->devfreq);
+  env->thermal_count = env_scan(BENCH_SYSFS_ROOT "/class/thermal",
+                                "thermal_zone", "type", NULL, "temp",
+                                env->thermal);
+}
+
+/* Prints items scaled to unit, "?" for values which could not be read. */
+static void env_print_items(const char *kind, const struct bench_env_item *items,
+                            int count, double scale, int precision,
+                            const char *unit) {
+  int i;
+
+  for (i = 0; i < count; i++) {
+    printf("%s%s ", i ? ", " : kind, items[i].name);
+    if (items[i].value < 0)
+      printf("?%s", unit);
+    else
+      printf("%.*f%s", precision, items[i].value / scale, unit);
+    if (items[i].governor[0])
+      printf(" %s", items[i].governor);
+  }
+}
+
+static void env_print(const char *indent, const struct bench_env *env) {
+  printf("%s%s", indent, env_policy);
+  env_print_items("; cpufreq ", env->cpufreq, env->cpufreq_count, 1e3, 0,
+                  "MHz");
+  env_print_items("; devfreq ", env->devfreq, env->devfreq_count, 1e6, 0,
+                  "MHz");
+  env_print_items("; thermal ", env->thermal, env->thermal_count, 1e3, 1,
+                  "C");
+  printf("\n");
+}
+
+static int env_compare(const char *kind, const struct bench_env_item *start,
+                       int start_count, const struct bench_env_item *now,
+                       int now_count, long long tolerance, int warn) {
+  int i, changes = 0;
+
+  if (start_count != now_count) {
+    if (warn)
+      printf("WARNING: %s entries changed from %d to %d\n", kind,
+             start_count, now_count);
+    return 1;
+  }
+  for (i = 0; i < now_count; i++) {
+    long long delta = now[i].value - start[i].value;
+
+    if (strcmp(start[i].governor, now[i].governor)) {
+      if (warn)
+        printf("WARNING: %s %s governor changed from %s to %s\n", kind,
+               now[i].name, start[i].governor, now[i].governor);
+      changes++;
+    }
+    if (delta > tolerance || -delta > tolerance) {
+      if (warn)
+        printf("WARNING: %s %s changed from %lld to %lld\n", kind,
+               now[i].name, start[i].value, now[i].value);
+      changes++;
+    }
+  }
+  return changes;
+}
+
+static int env_changes(const struct bench_env *now, int warn) {
+  return env_compare("cpufreq", env_start.cpufreq, env_start.cpufreq_count,
+                     now->cpufreq, now->cpufreq_count, 0, warn) +
+         env_compare("devfreq", env_start.devfreq, env_start.devfreq_count,
+                     now->devfreq, now->devfreq_count, 0, warn) +
+         env_compare("thermal", env_start.thermal, env_start.thermal_count,
+                     now->thermal, now->thermal_count, BENCH_ENV_TEMP_DELTA,
+                     warn);
+}
+
+int bench_env_setup(const char *cpus, int fifo_priority) {
+  const char *pinned = cpus ? cpus : "all";
+  int ret = 0, fifo = 0;
+
+#ifdef __linux__
+  if (cpus) {
+    cpu_set_t set;
+    const char *p = cpus;
+    int first, last, cpu;
+
+    CPU_ZERO(&set);
+    while (*p) {
+      char *end;
+
+      first = last = strtol(p, &end, 10);
+      if (end == p)
+        break;
+      if (*end == '-')
+        last = strtol(end + 1, &end, 10);
+      for (cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        CPU_SET(cpu, &set);
+      p = *end == ',' ? end + 1 : end;
+    }
+    if (*p || !CPU_COUNT(&set) || sched_setaffinity(0, sizeof(set), &set)) {
+      printf("FAILED to pin to cpus %s\n", cpus);
+      pinned = "all";
+      ret = -1;
+    }
+  }
+  if (fifo_priority > 0) {
+    struct sched_param param = {.sched_priority = fifo_priority};
+
+    if (sched_setscheduler(0, SCHED_FIFO, &param)) {
+      printf("FAILED to set SCHED_FIFO %d, root or CAP_SYS_NICE needed\n",
+             fifo_priority);
+      ret = -1;
+    } else {
+      fifo = fifo_priority;
+    }
+  }
+#else
+  if (cpus || fifo_priority > 0) {
+    printf("FAILED to pin or change the scheduler, not supported\n");
+    pinned = "all";
+    ret = -1;
+  }
+#endif
+  if (fifo)
+    snprintf(env_policy, sizeof(env_policy), "cpus %s, SCHED_FIFO %d", pinned,
+             fifo);
+  else
+    snprintf(env_policy, sizeof(env_policy), "cpus %s, SCHED_OTHER", pinned);
+
+  bench_env_capture(&env_start);
+  env_active = 1;
+  env_print("environment at start: ", &env_start);
+  return ret;
+}
+
+int bench_env_check(void) {
+  struct bench_env now;
+
+  if (!env_active)
+    return 0;
+  bench_env_capture(&now);
+  env_print("environment at end: ", &now);
+  return env_changes(&now, 1);
+}
+
+long long bench_surface_bytes(const struct g2d_surface *surface) {
+  long long pixels = (long long)(surface->right - surface->left) *
+                     (surface->bottom - surface->top);
+
+  return pixels * format_bpp(surface->format) / 8;
+}
+
+void bench_blit_bytes(const struct g2d_surface *src,
+                      const struct g2d_surface *dst, int blend,
+                      struct bench_bytes *bytes) {
+  bytes->read = bench_surface_bytes(src);
+  bytes->written = bench_surface_bytes(dst);
+  if (blend)
+    bytes->read += bytes->written;
+}
+
+void bench_clear_bytes(const struct g2d_surface *dst,
+                       struct bench_bytes *bytes) {
+  bytes->read = 0;
+  bytes->written = bench_surface_bytes(dst);
+}
+
+void bench_copy_bytes(long long size, struct bench_bytes *bytes) {
+  bytes->read = size;
+  bytes->written = size;
+}
+
+double bench_measure_memcpy_gbps(long long size, int loops) {
+  void *src, *dst;
+  long long t1, t2;
+  int i;
+
+  src = malloc(size);
+  dst = malloc(size);
+  if (!src || !dst || loops < 1) {
+    free(src);
+    free(dst);
+    return 0;
+  }
+
+  /* fault the pages in and warm up before timing */
+  memset(src, 0x5a, size);
+  memset(dst, 0, size);
+  memcpy(dst, src, size);
+
+  t1 = bench_get_time_us();
+  for (i = 0; i < loops; i++)
+    memcpy(dst, src, size);
+  t2 = bench_get_time_us();
+
+  free(src);
+  free(dst);
+
+  if (t2 <= t1)
+    return 0;
+  return 2.0 * size * loops / (t2 - t1) / 1000;
+}
+
+void bench_report_bytes(const struct bench_bytes *bytes, int time_us,
+                        double peak_gbps) {
+  double gbps, pct;
+
+  if (time_us <= 0)
+    return;
+
+  gbps = (double)(bytes->read + bytes->written) / time_us / 1000;
+  pct = peak_gbps > 0 ? 100 * gbps / peak_gbps : 0;
+
+  printf("    read %.1fMB, written %.1fMB, %.2fGB/s, %.0f%% of memcpy peak, "
+         "%s\n",
+         bytes->read / 1e6, bytes->written / 1e6, gbps, pct,
+         pct >= BENCH_BW_BOUND_PCT ? "bandwidth-bound" : "compute-bound");
+
+  if (env_active) {
+    struct bench_env now;
+
+    bench_env_capture(&now);
+    env_print(env_changes(&now, 0) ? "    env (changed): " : "    env: ",
+              &now);
+  }
+}
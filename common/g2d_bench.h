@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_bench.h
+ *
+ * @brief Timing and statistics helpers shared by the g2d benchmarks
+ *
+ */
+
+#ifndef __G2D_BENCH_H__
+#define __G2D_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+/* Buffer size used to measure the CPU memcpy peak, well above any LLC. */
+#define BENCH_PEAK_SIZE (32 * 1024 * 1024)
+
+/* Operations reaching this share of the memcpy peak are bandwidth-bound. */
+#define BENCH_BW_BOUND_PCT 70
+
+/* Environment variable which, when set to 1, enables the hardware counters. */
+#define BENCH_COUNTERS_ENV "G2D_BENCH_COUNTERS"
+
+/*
+ * Environment variables of the adaptive mode: the target width of the 95%
+ * confidence interval of the median, in percent of the median, and the time
+ * budget of each section in ms.
+ */
+#define BENCH_PRECISION_ENV "G2D_BENCH_PRECISION"
+#define BENCH_BUDGET_ENV "G2D_BENCH_BUDGET_MS"
+#define BENCH_DEFAULT_BUDGET_MS 2000
+
+/* Samples kept per section in adaptive mode, and taken before any check. */
+#define BENCH_RUN_MAX_SAMPLES 4096
+#define BENCH_RUN_MIN_SAMPLES 10
+
+enum bench_counter {
+  BENCH_CYCLES,
+  BENCH_INSTRUCTIONS,
+  BENCH_LLC_MISSES,
+  BENCH_DTLB_MISSES,
+  BENCH_CTX_SWITCHES,
+  BENCH_COUNTER_COUNT,
+};
+
+/*
+ * A measured section. The counters cover the calling thread only and are
+ * -1 when not enabled or not available on the platform.
+ */
+struct bench_section {
+  long long start_us;
+  long long elapsed_us;
+  long long counts[BENCH_COUNTER_COUNT];
+};
+
+/* At most this many cpufreq policies, devfreq devices and thermal zones. */
+#define BENCH_ENV_MAX 8
+
+/* Temperature drift, in millidegrees, beyond which a change is reported. */
+#define BENCH_ENV_TEMP_DELTA 5000
+
+struct bench_env_item {
+  char name[32];
+  char governor[32];
+  long long value; /* kHz for cpufreq, Hz for devfreq, m°C for thermal */
+};
+
+/* Platform state which moves benchmark results, read from sysfs. */
+struct bench_env {
+  int cpufreq_count;
+  int devfreq_count;
+  int thermal_count;
+  struct bench_env_item cpufreq[BENCH_ENV_MAX];
+  struct bench_env_item devfreq[BENCH_ENV_MAX];
+  struct bench_env_item thermal[BENCH_ENV_MAX];
+};
+
+struct bench_stats {
+  int count;
+  double min;
+  double max;
+  double mean;
+  double median;
+  double p90;
+  double p99;
+};
+
+/*
+ * Iterations of a measured section. Without BENCH_PRECISION_ENV it runs a
+ * fixed number of loops and the caller's g2d_finish ends the batch. In
+ * adaptive mode each iteration is finished and timed on its own, and the
+ * section stops once the confidence interval of the median is narrow enough
+ * or the budget is spent.
+ */
+struct bench_run {
+  int loops;           /* fixed mode iterations */
+  double target_pct;   /* 0 in fixed mode */
+  long long budget_ns; /* per section */
+  int running;
+  int count;           /* iterations done */
+  int next_check;
+  int converged;
+  long long start_ns;
+  long long last_ns;
+  double median_us;
+  double ci_low_us;
+  double ci_high_us;
+  double samples[BENCH_RUN_MAX_SAMPLES];
+};
+
+/* Reads the adaptive mode settings, loops is the fixed mode count. */
+void bench_run_init(struct bench_run *run, int loops);
+
+/*
+ * Loop condition of a section, restarting it after the previous one
+ * ended: while (bench_run_next(&run, handle)) g2d_blit(...);
+ */
+int bench_run_next(struct bench_run *run, void *handle);
+
+/* Time of one iteration: the median in adaptive mode, else the mean. */
+int bench_run_us(const struct bench_run *run, long long elapsed_us);
+
+/* Prints the precision achieved by an adaptive section. */
+void bench_run_report(const struct bench_run *run);
+
+/* Monotonic time in microseconds, not affected by wall clock changes. */
+long long bench_get_time_us(void);
+
+/* Same clock in ns, for calls short enough to need it. */
+long long bench_get_time_ns(void);
+
+/*
+ * Starts and stops a measured section. The perf_event counters are opened
+ * on first use when BENCH_COUNTERS_ENV is set. Returns the elapsed time.
+ */
+void bench_section_begin(struct bench_section *section);
+long long bench_section_end(struct bench_section *section);
+
+/* Prints the counters of a section divided by loops, if they are enabled. */
+void bench_section_report(const struct bench_section *section, int loops);
+
+/*
+ * Computes min/max/mean/median/p90/p99 over count samples.
+ * The samples array is sorted in place.
+ */
+void bench_compute_stats(double *samples, int count,
+                         struct bench_stats *stats);
+
+/*
+ * Prints the latency distribution of count samples in us, one line
+ * labelled name. The samples array is sorted in place.
+ */
+void bench_report_latency(const char *name, double *samples, int count);
+
+/*
+ * Time since the process was exec'd, in us, from /proc/self/stat. The
+ * start is only known to the kernel clock tick, typically 10ms. Returns -1
+ * when it is not available.
+ */
+long long bench_process_age_us(void);
+
+struct bench_bytes {
+  long long read;
+  long long written;
+};
+
+/*
+ * Optionally pins the process to cpus ("0-1,3", NULL to leave it) and
+ * switches it to SCHED_FIFO at fifo_priority (0 to leave it), then records
+ * and prints the start environment. From then on each bench_report_bytes
+ * line is followed by the current environment. Returns -1 if pinning or
+ * the scheduler change failed; the environment is recorded anyway.
+ */
+int bench_env_setup(const char *cpus, int fifo_priority);
+
+/* Reads the current cpufreq, devfreq and thermal state. */
+void bench_env_capture(struct bench_env *env);
+
+/*
+ * Prints the end environment and warns about each governor or frequency
+ * change and each temperature drift since bench_env_setup. Returns the
+ * number of changes.
+ */
+int bench_env_check(void);
+
+/* Bytes covered by the left/top/right/bottom rectangle of a surface. */
+long long bench_surface_bytes(const struct g2d_surface *surface);
+
+/*
+ * Bytes moved by one g2d_blit. The source rectangle is read and the
+ * destination rectangle written; with blending the destination is read too.
+ * For 90/270 rotation the destination rectangle is already the rotated one.
+ */
+void bench_blit_bytes(const struct g2d_surface *src,
+                      const struct g2d_surface *dst, int blend,
+                      struct bench_bytes *bytes);
+
+/* Bytes moved by one g2d_clear, which only writes the destination. */
+void bench_clear_bytes(const struct g2d_surface *dst,
+                       struct bench_bytes *bytes);
+
+/* Bytes moved by a plain copy of size bytes (memcpy, g2d_copy). */
+void bench_copy_bytes(long long size, struct bench_bytes *bytes);
+
+/*
+ * Measures the CPU memcpy bandwidth in GB/s on size byte buffers,
+ * counting both the bytes read and the bytes written (STREAM copy).
+ */
+double bench_measure_memcpy_gbps(long long size, int loops);
+
+/*
+ * Prints the bytes moved by one operation taking time_us, the achieved GB/s
+ * and its share of peak_gbps.
+ */
+void bench_report_bytes(const struct bench_bytes *bytes, int time_us,
+                        double peak_gbps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_buf_pool.c
+ *
+ * @brief Pool of g2d buffers recycled across frames
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "g2d.h"
+#include "g2d_buf_pool.h"
+
+#include "g2d_alloc_stats.h"
+#include "g2d_trace.h"
+
+struct pool_list {
+  struct g2d_buf *free[BUF_POOL_DEPTH];
+  int count;
+  long long hits;
+  long long misses;
+  long long released; /* freed because the list was full */
+};
+
+struct pool_live {
+  struct g2d_buf *buf;
+  int cls;
+  int cacheable;
+};
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static struct pool_list lists[BUF_POOL_CLASSES][2];
+static struct pool_live live[BUF_POOL_MAX_LIVE];
+static long long unpooled;
+
+/* 4 KB, 5 KB, 6 KB, 7 KB, 8 KB, 10 KB ... at most 25% above the request */
+static int pool_class_size(int cls) {
+  int shift = BUF_POOL_MIN_SHIFT + cls / 4;
+
+  return (1 << shift) + (cls % 4) * (1 << (shift - 2));
+}
+
+static int pool_class(int size) {
+  int cls;
+
+  for (cls = 0; cls < BUF_POOL_CLASSES; cls++)
+    if (pool_class_size(cls) >= size)
+      return cls;
+  return -1;
+}
+
+static void pool_exit(void) {
+  buf_pool_report();
+  buf_pool_trim();
+}
+
+/*
+ * Registered after the first g2d_alloc of the pool, so that it runs before
+ * the leak report of g2d_alloc_stats and the cached buffers are not listed.
+ */
+static void pool_init(void) { atexit(pool_exit); }
+
+struct g2d_buf *buf_pool_alloc(int size, int cacheable) {
+  struct pool_list *list;
+  struct g2d_buf *buf = NULL;
+  int i, cls = pool_class(size);
+
+  cacheable = !!cacheable;
+  if (cls < 0) {
+    pthread_mutex_lock(&pool_lock);
+    unpooled++;
+    pthread_mutex_unlock(&pool_lock);
+    return g2d_alloc(size, cacheable);
+  }
+
+  list = &lists[cls][cacheable];
+  pthread_mutex_lock(&pool_lock);
+  if (list->count) {
+    buf = list->free[--list->count];
+    list->hits++;
+  } else {
+    list->misses++;
+  }
+  pthread_mutex_unlock(&pool_lock);
+
+  if (!buf) {
+    buf = g2d_alloc(pool_class_size(cls), cacheable);
+    pthread_once(&pool_once, pool_init);
+    if (!buf)
+      return NULL;
+  }
+
+  pthread_mutex_lock(&pool_lock);
+  for (i = 0; i < BUF_POOL_MAX_LIVE; i++) {
+    if (!live[i].buf) {
+      live[i].buf = buf;
+      live[i].cls = cls;
+      live[i].cacheable = cacheable;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&pool_lock);
+  /* when the live table is full the buffer is simply freed later */
+  return buf;
+}
+
+void buf_pool_free(struct g2d_buf *buf) {
+  struct pool_list *list;
+  int i;
+
+  if (!buf)
+    return;
+
+  pthread_mutex_lock(&pool_lock);
+  for (i = 0; i < BUF_POOL_MAX_LIVE; i++)
+    if (live[i].buf == buf)
+      break;
+  if (i == BUF_POOL_MAX_LIVE) {
+    pthread_mutex_unlock(&pool_lock);
+    g2d_free(buf);
+    return;
+  }
+
+  list = &lists[live[i].cls][live[i].cacheable];
+  live[i].buf = NULL;
+  if (list->count < BUF_POOL_DEPTH) {
+    list->free[list->count++] = buf;
+    buf = NULL;
+  } else {
+    list->released++;
+  }
+  pthread_mutex_unlock(&pool_lock);
+
+  if (buf)
+    g2d_free(buf);
+}
+
+void buf_pool_trim(void) {
+  int cls, c;
+
+  pthread_mutex_lock(&pool_lock);
+  for (cls = 0; cls < BUF_POOL_CLASSES; cls++) {
+    for (c = 0; c < 2; c++) {
+      struct pool_list *list = &lists[cls][c];
+
+      while (list->count)
+        g2d_free(list->free[--list->count]);
+    }
+  }
+  pthread_mutex_unlock(&pool_lock);
+}
+
+void buf_pool_report(void) {
+  long long hits = 0, misses = 0;
+  int cls, c;
+
+  pthread_mutex_lock(&pool_lock);
+  printf("\n---------------- g2d buffer pool ----------------\n");
+  for (cls = 0; cls < BUF_POOL_CLASSES; cls++) {
+    for (c = 0; c < 2; c++) {
+      const struct pool_list *list = &lists[cls][c];
+      long long requests = list->hits + list->misses;
+
+      if (!requests)
+        continue;
+      printf("%8.1f KB %-13s %6lld requests, %5.1f%% hits, %lld g2d_alloc, "
+             "%lld released, %d cached\n",
+             pool_class_size(cls) / 1024.0, c ? "cacheable" : "non-cacheable",
+             requests, list->hits * 100.0 / requests, list->misses,
+             list->released, list->count);
+      hits += list->hits;
+      misses += list->misses;
+    }
+  }
+  if (hits + misses)
+    printf("total %lld requests, %.1f%% hits", hits + misses,
+           hits * 100.0 / (hits + misses));
+  else
+    printf("total no request");
+  printf(", %lld above the largest class\n", unpooled);
+  pthread_mutex_unlock(&pool_lock);
+}
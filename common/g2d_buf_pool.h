@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_buf_pool.h
+ *
+ * @brief Pool of g2d buffers recycled across frames
+ *
+ * Requests are rounded up to a size class, four per power of two from 4 KB,
+ * and freed buffers are kept on a free list per class and cacheability, so
+ * that a sample allocating the same buffers every frame stops calling
+ * g2d_alloc and g2d_free after the first one. Buffers keep their previous
+ * content. The cached buffers are released and the hit rates printed at exit.
+ */
+
+#ifndef __G2D_BUF_POOL_H__
+#define __G2D_BUF_POOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+#define BUF_POOL_MIN_SHIFT 12
+#define BUF_POOL_MAX_SHIFT 28
+#define BUF_POOL_CLASSES ((BUF_POOL_MAX_SHIFT - BUF_POOL_MIN_SHIFT) * 4 + 1)
+
+/* Free buffers kept per class and cacheability, the others are released. */
+#define BUF_POOL_DEPTH 4
+
+/* Buffers handed out at the same time which can go back to the pool. */
+#define BUF_POOL_MAX_LIVE 64
+
+/*
+ * Same contract as g2d_alloc, buf_size is the size of the class. Sizes
+ * above the largest class are allocated and freed directly.
+ */
+struct g2d_buf *buf_pool_alloc(int size, int cacheable);
+
+/* Puts a buffer of buf_pool_alloc back on its free list. */
+void buf_pool_free(struct g2d_buf *buf);
+
+/* Releases every free buffer. */
+void buf_pool_trim(void);
+
+/* Prints the hit rates per class, registered with atexit on first use. */
+void buf_pool_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
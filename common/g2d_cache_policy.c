@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_cache_policy.c
+ *
+ * @brief Cacheability of g2d buffers chosen from their access pattern
+ *
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g2d_bench.h"
+#include "g2d_cache_policy.h"
+
+#include "g2d_alloc_stats.h"
+#include "g2d_cache_stats.h"
+#include "g2d_trace.h"
+
+#define POLICY_CLASSES (CACHE_POLICY_MAX_SHIFT - CACHE_POLICY_MIN_SHIFT + 1)
+#define POLICY_REPEAT 3
+
+enum policy_force { POLICY_MEASURE, POLICY_CACHEABLE, POLICY_NON_CACHEABLE };
+
+/* Best of POLICY_REPEAT runs, in ns, for one size class. */
+struct policy_cost {
+  int measured; /* -1 when the buffers could not be allocated */
+  long long nc_write;
+  long long nc_read;
+  long long c_write;
+  long long c_read;
+  long long clean;
+  long long invalidate;
+};
+
+struct policy_buf {
+  struct g2d_buf *buf;
+  enum cache_access access;
+  int cacheable;
+};
+
+static const char *access_names[CACHE_ACCESS_COUNT] = {
+    "cpu write once", "cpu read back", "gpu only", "ping-pong"};
+
+static pthread_mutex_t policy_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t policy_once = PTHREAD_ONCE_INIT;
+static enum policy_force force;
+static struct policy_cost costs[POLICY_CLASSES];
+static struct policy_buf bufs[CACHE_POLICY_MAX_BUFS];
+static long long allocated[CACHE_ACCESS_COUNT][2]; /* by cacheability */
+static long long cleans, invalidates, flushes;
+static volatile uint64_t policy_sink;
+
+static void policy_init(void) {
+  const char *env = getenv(CACHE_POLICY_ENV);
+
+  if (env && !strcmp(env, "cacheable"))
+    force = POLICY_CACHEABLE;
+  else if (env && !strcmp(env, "non-cacheable"))
+    force = POLICY_NON_CACHEABLE;
+  atexit(cache_policy_report);
+}
+
+static int policy_class(int size) {
+  int cls = 0;
+
+  while (cls < POLICY_CLASSES - 1 &&
+         (1 << (cls + CACHE_POLICY_MIN_SHIFT)) < size)
+    cls++;
+  return cls;
+}
+
+static long long policy_min(long long a, long long b) {
+  return a && a < b ? a : b;
+}
+
+/* Sums every word into policy_sink so that the loads cannot be dropped. */
+static void policy_read(const void *ptr, int size) {
+  const uint64_t *p = ptr;
+  uint64_t sum = 0;
+  int i;
+
+  for (i = 0; i < size / 8; i++)
+    sum += p[i];
+  policy_sink += sum;
+}
+
+static void policy_measure(struct policy_cost *cost, int size) {
+  int probe = size < (1 << CACHE_POLICY_PROBE_SHIFT)
+                  ? size
+                  : 1 << CACHE_POLICY_PROBE_SHIFT;
+  struct g2d_buf *nc = g2d_alloc(probe, 0);
+  struct g2d_buf *c = g2d_alloc(probe, 1);
+  long long t, scale = size / probe;
+  int i;
+
+  cost->measured = -1;
+  if (!nc || !c) {
+    printf("cache policy: no %d KB probe buffers, %d KB buffers will be "
+           "non-cacheable\n",
+           probe / 1024, size / 1024);
+    goto out;
+  }
+
+  /* the first run also faults the pages in */
+  for (i = 0; i < POLICY_REPEAT; i++) {
+    t = bench_get_time_ns();
+    memset(nc->buf_vaddr, i, probe);
+    cost->nc_write = policy_min(cost->nc_write, bench_get_time_ns() - t);
+
+    t = bench_get_time_ns();
+    policy_read(nc->buf_vaddr, probe);
+    cost->nc_read = policy_min(cost->nc_read, bench_get_time_ns() - t);
+
+    t = bench_get_time_ns();
+    memset(c->buf_vaddr, i, probe);
+    cost->c_write = policy_min(cost->c_write, bench_get_time_ns() - t);
+
+    t = bench_get_time_ns();
+    g2d_cache_op(c, G2D_CACHE_CLEAN);
+    cost->clean = policy_min(cost->clean, bench_get_time_ns() - t);
+
+    t = bench_get_time_ns();
+    g2d_cache_op(c, G2D_CACHE_INVALIDATE);
+    cost->invalidate = policy_min(cost->invalidate, bench_get_time_ns() - t);
+
+    t = bench_get_time_ns();
+    policy_read(c->buf_vaddr, probe);
+    cost->c_read = policy_min(cost->c_read, bench_get_time_ns() - t);
+  }
+  cost->nc_write *= scale;
+  cost->nc_read *= scale;
+  cost->c_write *= scale;
+  cost->c_read *= scale;
+  cost->clean *= scale;
+  cost->invalidate *= scale;
+  cost->measured = 1;
+
+out:
+  if (nc)
+    g2d_free(nc);
+  if (c)
+    g2d_free(c);
+}
+
+/* Cost in ns of one use of the buffer, cacheable or not. */
+static long long policy_cost(const struct policy_cost *cost,
+                             enum cache_access access, int cacheable) {
+  switch (access) {
+  case CACHE_CPU_WRITE_ONCE:
+    return cacheable ? cost->c_write + cost->clean : cost->nc_write;
+  case CACHE_CPU_READ_BACK:
+    return cacheable ? cost->invalidate + cost->c_read : cost->nc_read;
+  case CACHE_PING_PONG:
+    return cacheable ? cost->c_write + cost->clean + cost->invalidate +
+                           cost->c_read
+                     : cost->nc_write + cost->nc_read;
+  default:
+    return 0;
+  }
+}
+
+int cache_policy_cacheable(int size, enum cache_access access) {
+  struct policy_cost *cost;
+  int cacheable;
+
+  pthread_once(&policy_once, policy_init);
+  if (access == CACHE_GPU_ONLY || force == POLICY_NON_CACHEABLE)
+    return 0;
+  if (force == POLICY_CACHEABLE)
+    return 1;
+
+  pthread_mutex_lock(&policy_lock);
+  cost = &costs[policy_class(size)];
+  if (!cost->measured)
+    policy_measure(cost, 1 << (policy_class(size) + CACHE_POLICY_MIN_SHIFT));
+  cacheable = cost->measured > 0 &&
+              policy_cost(cost, access, 1) < policy_cost(cost, access, 0);
+  pthread_mutex_unlock(&policy_lock);
+  return cacheable;
+}
+
+static struct policy_buf *policy_find(struct g2d_buf *buf) {
+  int i;
+
+  for (i = 0; i < CACHE_POLICY_MAX_BUFS; i++)
+    if (bufs[i].buf == buf)
+      return &bufs[i];
+  return NULL;
+}
+
+struct g2d_buf *cache_policy_alloc(int size, enum cache_access access) {
+  int cacheable = cache_policy_cacheable(size, access);
+  struct g2d_buf *buf = g2d_alloc(size, cacheable);
+  struct policy_buf *pb;
+
+  if (!buf)
+    return NULL;
+
+  pthread_mutex_lock(&policy_lock);
+  pb = policy_find(NULL);
+  if (!pb && cacheable) {
+    /* the cache ops of an untracked buffer would be skipped */
+    pthread_mutex_unlock(&policy_lock);
+    printf("cache policy: more than %d buffers, %d KB allocated "
+           "non-cacheable\n",
+           CACHE_POLICY_MAX_BUFS, size / 1024);
+    g2d_free(buf);
+    cacheable = 0;
+    buf = g2d_alloc(size, 0);
+    if (!buf)
+      return NULL;
+    pthread_mutex_lock(&policy_lock);
+    pb = policy_find(NULL);
+  }
+  allocated[access][cacheable]++;
+  if (pb) {
+    pb->buf = buf;
+    pb->access = access;
+    pb->cacheable = cacheable;
+  }
+  if (cacheable && access == CACHE_CPU_READ_BACK)
+    flushes++;
+  pthread_mutex_unlock(&policy_lock);
+
+  if (cacheable && access == CACHE_CPU_READ_BACK)
+    g2d_cache_op(buf, G2D_CACHE_FLUSH);
+  return buf;
+}
+
+void cache_policy_free(struct g2d_buf *buf) {
+  struct policy_buf *pb;
+
+  if (!buf)
+    return;
+
+  pthread_mutex_lock(&policy_lock);
+  pb = policy_find(buf);
+  if (pb)
+    pb->buf = NULL;
+  pthread_mutex_unlock(&policy_lock);
+  g2d_free(buf);
+}
+
+void cache_policy_cpu_done(struct g2d_buf *buf) {
+  struct policy_buf *pb;
+  int clean;
+
+  pthread_mutex_lock(&policy_lock);
+  pb = policy_find(buf);
+  clean = pb && pb->cacheable &&
+          (pb->access == CACHE_CPU_WRITE_ONCE ||
+           pb->access == CACHE_PING_PONG);
+  cleans += clean;
+  pthread_mutex_unlock(&policy_lock);
+
+  if (clean)
+    g2d_cache_op(buf, G2D_CACHE_CLEAN);
+}
+
+void cache_policy_gpu_done(struct g2d_buf *buf) {
+  struct policy_buf *pb;
+  int invalidate;
+
+  pthread_mutex_lock(&policy_lock);
+  pb = policy_find(buf);
+  invalidate = pb && pb->cacheable &&
+               (pb->access == CACHE_CPU_READ_BACK ||
+                pb->access == CACHE_PING_PONG);
+  invalidates += invalidate;
+  pthread_mutex_unlock(&policy_lock);
+
+  if (invalidate)
+    g2d_cache_op(buf, G2D_CACHE_INVALIDATE);
+}
+
+void cache_policy_report(void) {
+  int cls, a;
+
+  pthread_mutex_lock(&policy_lock);
+  printf("\n---------------- g2d cache policy ----------------\n");
+  if (force != POLICY_MEASURE)
+    printf("forced %s by %s\n",
+           force == POLICY_CACHEABLE ? "cacheable" : "non-cacheable",
+           CACHE_POLICY_ENV);
+  for (cls = 0; cls < POLICY_CLASSES; cls++) {
+    const struct policy_cost *cost = &costs[cls];
+    double kb = (1 << (cls + CACHE_POLICY_MIN_SHIFT)) / 1024.0;
+
+    if (cost->measured < 0)
+      printf("%8.0f KB not measured, allocation failed\n", kb);
+    if (cost->measured <= 0)
+      continue;
+    printf("%8.0f KB non-cacheable write %.1fus read %.1fus, cacheable write "
+           "%.1fus read %.1fus clean %.1fus invalidate %.1fus\n",
+           kb, cost->nc_write / 1e3, cost->nc_read / 1e3, cost->c_write / 1e3,
+           cost->c_read / 1e3, cost->clean / 1e3, cost->invalidate / 1e3);
+    for (a = 0; a < CACHE_ACCESS_COUNT; a++) {
+      long long c = policy_cost(cost, a, 1), nc = policy_cost(cost, a, 0);
+
+      if (a != CACHE_GPU_ONLY)
+        printf("%11s %-15s %s, %.1fus vs %.1fus per use\n", "",
+               access_names[a], c < nc ? "cacheable" : "non-cacheable",
+               (c < nc ? c : nc) / 1e3, (c < nc ? nc : c) / 1e3);
+    }
+  }
+  for (a = 0; a < CACHE_ACCESS_COUNT; a++)
+    if (allocated[a][0] + allocated[a][1])
+      printf("%-15s %lld cacheable, %lld non-cacheable buffers\n",
+             access_names[a], allocated[a][1], allocated[a][0]);
+  printf("cache ops issued: %lld clean, %lld invalidate, %lld flush\n", cleans,
+         invalidates, flushes);
+  pthread_mutex_unlock(&policy_lock);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_cache_policy.h
+ *
+ * @brief Cacheability of g2d buffers chosen from their access pattern
+ *
+ * Instead of a hardcoded CACHEABLE, a buffer is allocated for one of the
+ * access patterns below. The first allocation of each power of two size
+ * times CPU writes and reads on a non-cacheable and a cacheable buffer of
+ * that size, or of 4 MB for larger sizes, together with the clean and
+ * invalidate they need, and the cheaper side is used for every pattern at
+ * that size. The application then calls cache_policy_cpu_done and
+ * cache_policy_gpu_done at the hand overs, which only issue the cache
+ * operation the pattern requires, and only on cacheable buffers. The
+ * decisions are printed at exit.
+ */
+
+#ifndef __G2D_CACHE_POLICY_H__
+#define __G2D_CACHE_POLICY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+/*
+ * Environment variable forcing the decision: "cacheable" or
+ * "non-cacheable", measured when unset.
+ */
+#define CACHE_POLICY_ENV "G2D_CACHE_POLICY"
+
+#define CACHE_POLICY_MIN_SHIFT 12
+#define CACHE_POLICY_MAX_SHIFT 28
+
+/*
+ * Larger sizes are timed on buffers of 4 MB and the costs scaled, they are
+ * linear in the size once past the caches.
+ */
+#define CACHE_POLICY_PROBE_SHIFT 22
+
+/* Buffers of the policy alive at the same time, more are non-cacheable. */
+#define CACHE_POLICY_MAX_BUFS 64
+
+enum cache_access {
+  CACHE_CPU_WRITE_ONCE, /* filled by the CPU, then only read by g2d */
+  CACHE_CPU_READ_BACK,  /* written by g2d, read by the CPU */
+  CACHE_GPU_ONLY,       /* never touched by the CPU */
+  CACHE_PING_PONG,      /* written and read by both, every frame */
+  CACHE_ACCESS_COUNT,
+};
+
+/* Returns 1 if a buffer of size bytes used with access should be cacheable. */
+int cache_policy_cacheable(int size, enum cache_access access);
+
+/*
+ * Same contract as g2d_alloc, the cacheability coming from
+ * cache_policy_cacheable. A cacheable read back buffer is flushed once so
+ * that no dirty line can later overwrite what g2d writes.
+ */
+struct g2d_buf *cache_policy_alloc(int size, enum cache_access access);
+
+/* Frees any g2d buffer, forgetting it if it came from cache_policy_alloc. */
+void cache_policy_free(struct g2d_buf *buf);
+
+/* The CPU wrote buf and g2d reads it next: cleans it when needed. */
+void cache_policy_cpu_done(struct g2d_buf *buf);
+
+/* g2d wrote buf, after g2d_finish, and the CPU reads it next. */
+void cache_policy_gpu_done(struct g2d_buf *buf);
+
+/* Prints the measured costs and decisions, registered with atexit. */
+void cache_policy_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
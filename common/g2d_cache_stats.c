@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_cache_stats.c
+ *
+ * @brief Cost accounting of the g2d cache maintenance operations
+ *
+ */
+
+#include <stdio.h>
+
+#include "g2d_bench.h"
+#include "g2d_cache_stats.h"
+#include "g2d_trace.h"
+
+static const char *cache_op_names[CACHE_STATS_OPS] = {
+    [G2D_CACHE_CLEAN] = "clean",
+    [G2D_CACHE_FLUSH] = "flush",
+    [G2D_CACHE_INVALIDATE] = "invalidate",
+};
+
+static struct cache_stats totals;
+
+/* totals at the previous cache_stats_report() */
+static struct cache_stats reported;
+
+int cache_stats_op(struct g2d_buf *buf, enum g2d_cache_mode op) {
+  long long start = bench_get_time_ns();
+  /* the parentheses call the library, not the macro of the header */
+  int ret = TRACE_CALL("g2d_cache_op", (g2d_cache_op)(buf, op));
+
+  if ((unsigned)op < CACHE_STATS_OPS) {
+    __atomic_fetch_add(&totals.calls[op], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.bytes[op], buf ? buf->buf_size : 0,
+                       __ATOMIC_RELAXED);
+    __atomic_fetch_add(&totals.time_ns[op], bench_get_time_ns() - start,
+                       __ATOMIC_RELAXED);
+  }
+  return ret;
+}
+
+void cache_stats_get(struct cache_stats *stats) {
+  int i;
+
+  for (i = 0; i < CACHE_STATS_OPS; i++) {
+    stats->calls[i] = __atomic_load_n(&totals.calls[i], __ATOMIC_RELAXED);
+    stats->bytes[i] = __atomic_load_n(&totals.bytes[i], __ATOMIC_RELAXED);
+    stats->time_ns[i] = __atomic_load_n(&totals.time_ns[i], __ATOMIC_RELAXED);
+  }
+}
+
+void cache_stats_diff(const struct cache_stats *end,
+                      const struct cache_stats *start,
+                      struct cache_stats *stats) {
+  int i;
+
+  for (i = 0; i < CACHE_STATS_OPS; i++) {
+    stats->calls[i] = end->calls[i] - start->calls[i];
+    stats->bytes[i] = end->bytes[i] - start->bytes[i];
+    stats->time_ns[i] = end->time_ns[i] - start->time_ns[i];
+  }
+}
+
+long long cache_stats_time_ns(const struct cache_stats *stats) {
+  long long ns = 0;
+  int i;
+
+  for (i = 0; i < CACHE_STATS_OPS; i++)
+    ns += stats->time_ns[i];
+  return ns;
+}
+
+void cache_stats_report(const char *name) {
+  struct cache_stats now, delta;
+  int i, any = 0;
+
+  cache_stats_get(&now);
+  cache_stats_diff(&now, &reported, &delta);
+  reported = now;
+
+  printf("%s cache ops:", name);
+  for (i = 0; i < CACHE_STATS_OPS; i++) {
+    if (!delta.calls[i])
+      continue;
+    printf(" %s %lld x, %.1f KB, %.1f us (%.2f GB/s);", cache_op_names[i],
+           delta.calls[i], delta.bytes[i] / 1024.0, delta.time_ns[i] / 1e3,
+           delta.time_ns[i] ? (double)delta.bytes[i] / delta.time_ns[i] : 0);
+    any = 1;
+  }
+  printf(any ? "\n" : " none\n");
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_cache_stats.h
+ *
+ * @brief Cost accounting of the g2d cache maintenance operations
+ *
+ * Include this header after g2d.h: every g2d_cache_op of the including file
+ * then goes through cache_stats_op(), which counts the calls, bytes and time
+ * per operation type and records a g2d_trace.h event. Take a
+ * cache_stats_get() before and after a frame, or call cache_stats_report()
+ * after each one, to see what cacheable buffers cost.
+ */
+
+#ifndef __G2D_CACHE_STATS_H__
+#define __G2D_CACHE_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+/* G2D_CACHE_CLEAN, G2D_CACHE_FLUSH and G2D_CACHE_INVALIDATE */
+#define CACHE_STATS_OPS 3
+
+struct cache_stats {
+  long long calls[CACHE_STATS_OPS];
+  long long bytes[CACHE_STATS_OPS];
+  long long time_ns[CACHE_STATS_OPS];
+};
+
+/* Calls g2d_cache_op and accounts for it. Safe from any thread. */
+int cache_stats_op(struct g2d_buf *buf, enum g2d_cache_mode op);
+
+/* Totals since the start of the process. */
+void cache_stats_get(struct cache_stats *stats);
+
+/* stats = end - start, e.g. the operations of one frame. */
+void cache_stats_diff(const struct cache_stats *end,
+                      const struct cache_stats *start,
+                      struct cache_stats *stats);
+
+/* Sum of the time of all operation types, in ns. */
+long long cache_stats_time_ns(const struct cache_stats *stats);
+
+/* Prints the operations issued since the previous call, or the start. */
+void cache_stats_report(const char *name);
+
+#define g2d_cache_op(...) cache_stats_op(__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_format.c
+ *
+ * @brief Plane layout of the g2d pixel formats
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "g2d_format.h"
+
+#include "g2d_alloc_stats.h"
+#include "g2d_trace.h"
+
+#define RGB(f, bpp)                                                            \
+  { f, #f + 4, 1, {bpp}, 1, 1, 16 }
+#define PACKED_YUV(f)                                                          \
+  { f, #f + 4, 1, {16}, 2, 1, 16 }
+#define PLANAR_YUV(f, planes, chroma_bpp, h_sub, v_sub)                        \
+  { f, #f + 4, planes, {8, chroma_bpp, chroma_bpp}, h_sub, v_sub, 64 }
+
+static const struct format_desc formats[] = {
+    RGB(G2D_RGBA8888, 32),
+    RGB(G2D_RGBX8888, 32),
+    RGB(G2D_BGRA8888, 32),
+    RGB(G2D_BGRX8888, 32),
+    RGB(G2D_ARGB8888, 32),
+    RGB(G2D_ABGR8888, 32),
+    RGB(G2D_XRGB8888, 32),
+    RGB(G2D_XBGR8888, 32),
+    RGB(G2D_RGB888, 24),
+    RGB(G2D_BGR888, 24),
+    RGB(G2D_RGB565, 16),
+    RGB(G2D_BGR565, 16),
+    RGB(G2D_RGBA5551, 16),
+    RGB(G2D_RGBX5551, 16),
+    RGB(G2D_BGRA5551, 16),
+    RGB(G2D_BGRX5551, 16),
+    PACKED_YUV(G2D_YUYV),
+    PACKED_YUV(G2D_YVYU),
+    PACKED_YUV(G2D_UYVY),
+    PACKED_YUV(G2D_VYUY),
+    /* interleaved chroma, one 16 bit UV sample per 2x2 or 2x1 pixels */
+    PLANAR_YUV(G2D_NV12, 2, 16, 2, 2),
+    PLANAR_YUV(G2D_NV21, 2, 16, 2, 2),
+    PLANAR_YUV(G2D_NV16, 2, 16, 2, 1),
+    PLANAR_YUV(G2D_NV61, 2, 16, 2, 1),
+    /* YV12 has V in planes[1] and U in planes[2], the sizes are the same */
+    PLANAR_YUV(G2D_I420, 3, 8, 2, 2),
+    PLANAR_YUV(G2D_YV12, 3, 8, 2, 2),
+};
+
+const struct format_desc *format_find(enum g2d_format format) {
+  unsigned i;
+
+  for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+    if (formats[i].format == format)
+      return &formats[i];
+  return NULL;
+}
+
+int format_bpp(enum g2d_format format) {
+  const struct format_desc *desc = format_find(format);
+  int sub, bits, i;
+
+  if (!desc)
+    return 0;
+
+  sub = desc->h_sub * desc->v_sub;
+  bits = desc->bpp[0] * sub;
+  for (i = 1; i < desc->planes; i++)
+    bits += desc->bpp[i];
+  return bits / sub;
+}
+
+int format_layout(enum g2d_format format, int stride, int height, int align,
+                  struct format_layout *layout) {
+  const struct format_desc *desc = format_find(format);
+  int offset = 0, i;
+
+  memset(layout, 0, sizeof(*layout));
+  if (!desc)
+    return -1;
+  if (align <= 0)
+    align = desc->align;
+
+  layout->desc = desc;
+  layout->aligned = 1;
+  for (i = 0; i < desc->planes; i++) {
+    int width = stride, rows = height;
+
+    if (i) {
+      width = (stride + desc->h_sub - 1) / desc->h_sub;
+      rows = (height + desc->v_sub - 1) / desc->v_sub;
+    }
+    offset = (offset + align - 1) / align * align;
+    layout->offset[i] = offset;
+    layout->pitch[i] = width * desc->bpp[i] / 8;
+    layout->size[i] = layout->pitch[i] * rows;
+    if (offset % desc->align)
+      layout->aligned = 0;
+    offset += layout->size[i];
+  }
+  layout->total = offset;
+  return 0;
+}
+
+void format_set_planes(struct g2d_surface *surface, const struct g2d_buf *buf,
+                       const struct format_layout *layout) {
+  int i;
+
+  for (i = 0; i < FORMAT_MAX_PLANES; i++)
+    surface->planes[i] =
+        i < layout->desc->planes ? buf->buf_paddr + layout->offset[i] : 0;
+}
+
+struct g2d_buf *format_alloc(struct g2d_surface *surface,
+                             struct format_layout *layout, int cacheable) {
+  struct format_layout local;
+  struct g2d_buf *buf;
+
+  if (!layout)
+    layout = &local;
+  if (format_layout(surface->format, surface->stride, surface->height, 0,
+                    layout)) {
+    printf("format %d has no plane layout\n", surface->format);
+    return NULL;
+  }
+
+  buf = g2d_alloc(layout->total, cacheable);
+  if (!buf) {
+    printf("Fail to allocate %d bytes for a %s surface\n", layout->total,
+           layout->desc->name);
+    return NULL;
+  }
+  format_set_planes(surface, buf, layout);
+  return buf;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_format.h
+ *
+ * @brief Plane layout of the g2d pixel formats
+ *
+ * One descriptor per format gives its planes, the bits per sample of each
+ * plane, the chroma subsampling and the alignment g2d requires of each plane
+ * address: 16 bytes for RGB and packed YUV, 64 bytes for the planes of the
+ * semi-planar and planar YUV formats. Planes which miss it may still be
+ * accepted but fall off the fast path of the hardware. format_layout places
+ * all the planes of a surface in one buffer and format_alloc allocates it.
+ */
+
+#ifndef __G2D_FORMAT_H__
+#define __G2D_FORMAT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+#define FORMAT_MAX_PLANES 3
+
+/* Alignment argument of format_layout which keeps the planes back to back. */
+#define FORMAT_PACKED 1
+
+struct format_desc {
+  enum g2d_format format;
+  const char *name;
+  int planes;
+  int bpp[FORMAT_MAX_PLANES]; /* bits per sample of each plane */
+  int h_sub;                  /* chroma subsampling of planes 1 and 2 */
+  int v_sub;
+  int align; /* of each plane address, in bytes */
+};
+
+struct format_layout {
+  const struct format_desc *desc;
+  int offset[FORMAT_MAX_PLANES]; /* from the start of the buffer */
+  int pitch[FORMAT_MAX_PLANES];  /* bytes per row */
+  int size[FORMAT_MAX_PLANES];
+  int total;   /* bytes from the buffer start to the end of the last plane */
+  int aligned; /* every offset is a multiple of desc->align */
+};
+
+/* Returns the descriptor of format, or NULL if it is not in the table. */
+const struct format_desc *format_find(enum g2d_format format);
+
+/* Average bits per pixel over all planes, 0 for an unknown format. */
+int format_bpp(enum g2d_format format);
+
+/*
+ * Lays out the planes of a stride x height surface, stride in pixels as in
+ * g2d_surface, each plane starting on a multiple of align bytes, or of the
+ * alignment the format requires when align is 0. Returns -1 for an unknown
+ * format.
+ */
+int format_layout(enum g2d_format format, int stride, int height, int align,
+                  struct format_layout *layout);
+
+/* Points the planes of surface at the layout inside buf. */
+void format_set_planes(struct g2d_surface *surface, const struct g2d_buf *buf,
+                       const struct format_layout *layout);
+
+/*
+ * Allocates one g2d buffer holding every plane of surface, laid out from its
+ * format, stride and height with the required alignment, and sets its
+ * planes. layout may be NULL. Returns NULL on an unknown format or when the
+ * allocation fails.
+ */
+struct g2d_buf *format_alloc(struct g2d_surface *surface,
+                             struct format_layout *layout, int cacheable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
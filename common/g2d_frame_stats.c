@@ -0,0 +1,243 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_frame_stats.c
+ *
+ * @brief Frame time recorder for the Wayland paint loops
+ *
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g2d_bench.h"
+#include "g2d_cache_stats.h"
+#include "g2d_frame_stats.h"
+
+#define FRAME_STATS_DEFAULT_HZ 60
+
+/* intervals of this many vblanks and more share the last histogram row */
+#define FRAME_STATS_VBLANK_ROWS 6
+
+/* paint histogram rows, in quarters of the vblank period */
+#define FRAME_STATS_PAINT_ROWS 5
+
+#define FRAME_STATS_BAR 40
+
+static struct {
+  double *paint_us;    /* callback to commit */
+  double *interval_us; /* callback to callback */
+  double *cache_us;    /* g2d_cache_op time within the paint */
+  int count;
+  int intervals;
+  int max;
+  long long missed;
+  int janky;
+  double period_us;
+  long long first_us;
+  long long last_us;
+  long long begin_us;
+  struct cache_stats cache_begin;
+  struct cache_stats cache_total;
+} fs;
+
+static volatile sig_atomic_t fs_stop;
+
+static void frame_stats_signal(int sig) {
+  (void)sig;
+  fs_stop = 1;
+}
+
+void frame_stats_init(void) {
+  const char *env = getenv(FRAME_STATS_REFRESH_ENV);
+  double hz = env ? atof(env) : 0;
+  struct sigaction sa;
+
+  if (hz <= 0)
+    hz = FRAME_STATS_DEFAULT_HZ;
+  fs.period_us = 1e6 / hz;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = frame_stats_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  atexit(frame_stats_report);
+}
+
+int frame_stats_running(void) { return !fs_stop; }
+
+static int frame_stats_grow(void) {
+  int max = fs.max ? fs.max * 2 : 1024;
+  double *paint = realloc(fs.paint_us, max * sizeof(double));
+  double *interval, *cache;
+
+  if (!paint)
+    return -1;
+  fs.paint_us = paint;
+  interval = realloc(fs.interval_us, max * sizeof(double));
+  if (!interval)
+    return -1;
+  fs.interval_us = interval;
+  cache = realloc(fs.cache_us, max * sizeof(double));
+  if (!cache)
+    return -1;
+  fs.cache_us = cache;
+  fs.max = max;
+  return 0;
+}
+
+void frame_stats_begin(void) {
+  long long now = bench_get_time_us();
+
+  fs.begin_us = now;
+  cache_stats_get(&fs.cache_begin);
+  if (!fs.first_us) {
+    fs.first_us = now;
+  } else if (fs.intervals < fs.max || !frame_stats_grow()) {
+    double interval = now - fs.last_us;
+    /* a callback on time is one period after the previous one */
+    long long vblanks = (long long)(interval / fs.period_us + 0.5);
+
+    fs.interval_us[fs.intervals++] = interval;
+    if (vblanks > 1) {
+      fs.missed += vblanks - 1;
+      fs.janky++;
+    }
+  }
+  fs.last_us = now;
+}
+
+void frame_stats_end(void) {
+  struct cache_stats now, frame;
+  int i;
+
+  if (!fs.begin_us)
+    return;
+  cache_stats_get(&now);
+  cache_stats_diff(&now, &fs.cache_begin, &frame);
+  for (i = 0; i < CACHE_STATS_OPS; i++) {
+    fs.cache_total.calls[i] += frame.calls[i];
+    fs.cache_total.bytes[i] += frame.bytes[i];
+    fs.cache_total.time_ns[i] += frame.time_ns[i];
+  }
+
+  if (fs.count < fs.max || !frame_stats_grow()) {
+    fs.cache_us[fs.count] = cache_stats_time_ns(&frame) / 1e3;
+    fs.paint_us[fs.count++] = bench_get_time_us() - fs.begin_us;
+  }
+  fs.begin_us = 0;
+}
+
+static void frame_stats_bar(const char *label, int n, int total) {
+  int width = total ? (n * FRAME_STATS_BAR + total - 1) / total : 0;
+
+  fprintf(stderr, "  %-14s %7d %5.1f%% ", label, n,
+          total ? 100.0 * n / total : 0);
+  while (width--)
+    fputc('#', stderr);
+  fputc('\n', stderr);
+}
+
+static void frame_stats_line(const char *name, const struct bench_stats *st) {
+  fprintf(stderr, "%-9s min %7.2f  avg %7.2f  p50 %7.2f  p90 %7.2f  p99 %7.2f  "
+          "max %7.2f ms\n",
+          name, st->min / 1e3, st->mean / 1e3, st->median / 1e3,
+          st->p90 / 1e3, st->p99 / 1e3, st->max / 1e3);
+}
+
+void frame_stats_report(void) {
+  int vblank_rows[FRAME_STATS_VBLANK_ROWS] = {0};
+  int paint_rows[FRAME_STATS_PAINT_ROWS] = {0};
+  static const char *cache_ops[CACHE_STATS_OPS] = {
+      [G2D_CACHE_CLEAN] = "clean",
+      [G2D_CACHE_FLUSH] = "flush",
+      [G2D_CACHE_INVALIDATE] = "invalidate",
+  };
+  char label[32];
+  struct bench_stats st;
+  double elapsed, paint_total = 0, cache_total = 0;
+  int i, row;
+
+  if (!fs.count)
+    return;
+
+  for (i = 0; i < fs.intervals; i++) {
+    row = (int)(fs.interval_us[i] / fs.period_us + 0.5);
+    if (row < 1)
+      row = 1;
+    if (row > FRAME_STATS_VBLANK_ROWS)
+      row = FRAME_STATS_VBLANK_ROWS;
+    vblank_rows[row - 1]++;
+  }
+  for (i = 0; i < fs.count; i++) {
+    paint_total += fs.paint_us[i];
+    cache_total += fs.cache_us[i];
+    row = (int)(fs.paint_us[i] * 4 / fs.period_us);
+    if (row >= FRAME_STATS_PAINT_ROWS)
+      row = FRAME_STATS_PAINT_ROWS - 1;
+    paint_rows[row]++;
+  }
+
+  elapsed = (fs.last_us - fs.first_us) / 1e6;
+  fprintf(stderr,
+          "\n---------------- frame times: %d frames in %.1fs, %.1f fps, "
+          "%.1f Hz display ----------------\n",
+          fs.count, elapsed, elapsed > 0 ? fs.intervals / elapsed : 0,
+          1e6 / fs.period_us);
+
+  bench_compute_stats(fs.paint_us, fs.count, &st);
+  frame_stats_line("paint", &st);
+  if (fs.intervals) {
+    bench_compute_stats(fs.interval_us, fs.intervals, &st);
+    frame_stats_line("interval", &st);
+  }
+  fprintf(stderr, "missed vblanks: %lld, in %d of %d intervals (%.1f%%)\n",
+          fs.missed, fs.janky, fs.intervals,
+          fs.intervals ? 100.0 * fs.janky / fs.intervals : 0);
+
+  if (cache_total > 0) {
+    bench_compute_stats(fs.cache_us, fs.count, &st);
+    frame_stats_line("cache op", &st);
+    fprintf(stderr, "cache ops per frame, %.1f%% of the paint time:",
+            100.0 * cache_total / paint_total);
+    for (i = 0; i < CACHE_STATS_OPS; i++) {
+      if (!fs.cache_total.calls[i])
+        continue;
+      fprintf(stderr, " %s %.1f x %.1f KB;", cache_ops[i],
+              (double)fs.cache_total.calls[i] / fs.count,
+              fs.cache_total.bytes[i] / 1024.0 / fs.cache_total.calls[i]);
+    }
+    fprintf(stderr, "\n");
+  } else {
+    fprintf(stderr, "cache ops per frame: none\n");
+  }
+
+  fprintf(stderr, "\ninterval histogram (vblanks)\n");
+  for (i = 0; i < FRAME_STATS_VBLANK_ROWS; i++) {
+    snprintf(label, sizeof(label), "%s%d",
+             i == FRAME_STATS_VBLANK_ROWS - 1 ? ">=" : "", i + 1);
+    frame_stats_bar(label, vblank_rows[i], fs.intervals);
+  }
+
+  fprintf(stderr, "paint histogram (share of the vblank period)\n");
+  for (i = 0; i < FRAME_STATS_PAINT_ROWS; i++) {
+    if (i == FRAME_STATS_PAINT_ROWS - 1)
+      snprintf(label, sizeof(label), ">100%%");
+    else
+      snprintf(label, sizeof(label), "<%d%%", (i + 1) * 25);
+    frame_stats_bar(label, paint_rows[i], fs.count);
+  }
+
+  free(fs.paint_us);
+  free(fs.interval_us);
+  free(fs.cache_us);
+  memset(&fs, 0, sizeof(fs));
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_frame_stats.h
+ *
+ * @brief Frame time recorder for the Wayland paint loops
+ *
+ * Call frame_stats_begin() when a frame callback arrives and
+ * frame_stats_end() once the frame is committed. The paint duration, the
+ * interval between two callbacks and the vblanks missed are kept for every
+ * frame and summarised at exit, with their histograms.
+ */
+
+#ifndef __G2D_FRAME_STATS_H__
+#define __G2D_FRAME_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Display refresh rate in Hz used to count missed vblanks, default 60. */
+#define FRAME_STATS_REFRESH_ENV "G2D_REFRESH_HZ"
+
+/*
+ * Installs the exit report and a SIGINT/SIGTERM handler which makes
+ * frame_stats_running() return 0, so the event loop can end cleanly.
+ */
+void frame_stats_init(void);
+int frame_stats_running(void);
+
+void frame_stats_begin(void);
+void frame_stats_end(void);
+
+/* Prints the summary, called at exit by frame_stats_init(). */
+void frame_stats_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_hugepage.c
+ *
+ * @brief Huge page backed CPU buffers
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "g2d_hugepage.h"
+
+#define HUGE_DEFAULT_SIZE (2 * 1024 * 1024)
+
+static const char *mode_names[] = {"none", "thp", "hugetlb"};
+
+enum huge_mode huge_mode_env(void) {
+  const char *env = getenv(HUGE_PAGE_ENV);
+  int i;
+
+  for (i = HUGE_NONE; env && i <= HUGE_HUGETLB; i++)
+    if (!strcmp(env, mode_names[i]))
+      return i;
+  return HUGE_NONE;
+}
+
+const char *huge_mode_name(enum huge_mode mode) {
+  return mode <= HUGE_HUGETLB ? mode_names[mode] : "?";
+}
+
+size_t huge_page_size(void) {
+  static size_t size;
+  char line[128];
+  unsigned long kb;
+  FILE *f;
+
+  if (size)
+    return size;
+  size = HUGE_DEFAULT_SIZE;
+  f = fopen("/proc/meminfo", "r");
+  if (!f)
+    return size;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1 && kb) {
+      size = kb * 1024;
+      break;
+    }
+  }
+  fclose(f);
+  return size;
+}
+
+static size_t huge_round(size_t size, size_t page) {
+  return (size + page - 1) / page * page;
+}
+
+static int huge_map_hugetlb(struct huge_buf *buf) {
+#ifdef MAP_HUGETLB
+  void *ptr;
+
+  buf->map_size = huge_round(buf->size, huge_page_size());
+  ptr = mmap(NULL, buf->map_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (ptr == MAP_FAILED)
+    return -1;
+  buf->ptr = ptr;
+  return 0;
+#else
+  (void)buf;
+  return -1;
+#endif
+}
+
+/* Maps one huge page more and trims it so that the start is aligned. */
+static int huge_map_thp(struct huge_buf *buf) {
+#ifdef MADV_HUGEPAGE
+  size_t page = huge_page_size(), head;
+  uint8_t *ptr;
+
+  buf->map_size = huge_round(buf->size, page);
+  ptr = mmap(NULL, buf->map_size + page, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return -1;
+
+  head = (page - (uintptr_t)ptr % page) % page;
+  if (head)
+    munmap(ptr, head);
+  munmap(ptr + head + buf->map_size, page - head);
+  ptr += head;
+
+  if (madvise(ptr, buf->map_size, MADV_HUGEPAGE)) {
+    munmap(ptr, buf->map_size);
+    return -1;
+  }
+  buf->ptr = ptr;
+  return 0;
+#else
+  (void)buf;
+  return -1;
+#endif
+}
+
+static int huge_map_none(struct huge_buf *buf) {
+  void *ptr;
+
+  buf->map_size = huge_round(buf->size, sysconf(_SC_PAGESIZE));
+  ptr = mmap(NULL, buf->map_size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return -1;
+  buf->ptr = ptr;
+  return 0;
+}
+
+int huge_alloc(struct huge_buf *buf, size_t size, enum huge_mode mode) {
+  memset(buf, 0, sizeof(*buf));
+  buf->size = size;
+  if (!size)
+    return -1;
+
+  if (mode >= HUGE_HUGETLB && !huge_map_hugetlb(buf)) {
+    buf->mode = HUGE_HUGETLB;
+    return 0;
+  }
+  if (mode >= HUGE_THP && !huge_map_thp(buf)) {
+    buf->mode = HUGE_THP;
+    return 0;
+  }
+  if (!huge_map_none(buf)) {
+    buf->mode = HUGE_NONE;
+    return 0;
+  }
+
+  buf->ptr = NULL;
+  return -1;
+}
+
+void huge_free(struct huge_buf *buf) {
+  if (buf->ptr)
+    munmap(buf->ptr, buf->map_size);
+  buf->ptr = NULL;
+}
+
+size_t huge_backed(const struct huge_buf *buf) {
+  unsigned long start, end, kb;
+  uintptr_t addr = (uintptr_t)buf->ptr;
+  size_t backed = 0;
+  char line[256];
+  int found = 0;
+  FILE *f;
+
+  if (!buf->ptr)
+    return 0;
+  f = fopen("/proc/self/smaps", "r");
+  if (!f)
+    return 0;
+
+  /* a range line opens each mapping, its fields follow */
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "%lx-%lx ", &start, &end) == 2 &&
+        strchr(line, '-') < strchr(line, ' ')) {
+      if (found)
+        break;
+      found = addr >= start && addr < end;
+    } else if (found) {
+      if (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1)
+        backed += kb * 1024;
+      else if (sscanf(line, "KernelPageSize: %lu kB", &kb) == 1 &&
+               kb * 1024 > (unsigned long)sysconf(_SC_PAGESIZE))
+        backed = end - start;
+    }
+  }
+  fclose(f);
+  return backed < buf->map_size ? backed : buf->map_size;
+}
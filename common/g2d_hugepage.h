@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_hugepage.h
+ *
+ * @brief Huge page backed CPU buffers
+ *
+ * A 4K RGBA frame spans over 8000 4 KB pages, so a CPU pass over it misses
+ * the dTLB on nearly every page. huge_alloc maps anonymous memory either
+ * from the reserved hugetlbfs pool (MAP_HUGETLB) or aligned to the huge page
+ * size and advised with MADV_HUGEPAGE for transparent huge pages, falling
+ * back to the next mode when one is unavailable. It applies to the memory
+ * the application maps itself, such as the user buffers of g2d_basic_test
+ * or buffers imported with g2d_buf_from_virt_addr; the mapping of g2d_alloc
+ * buffers is chosen by the driver.
+ */
+
+#ifndef __G2D_HUGEPAGE_H__
+#define __G2D_HUGEPAGE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Environment variable selecting the mode: "hugetlb", "thp" or "none". */
+#define HUGE_PAGE_ENV "G2D_HUGE_PAGES"
+
+enum huge_mode {
+  HUGE_NONE,    /* base pages */
+  HUGE_THP,     /* transparent huge pages, madvise(MADV_HUGEPAGE) */
+  HUGE_HUGETLB, /* reserved huge pages, mmap(MAP_HUGETLB) */
+};
+
+struct huge_buf {
+  void *ptr;
+  size_t size;     /* requested */
+  size_t map_size; /* rounded up to the page size of the mode */
+  enum huge_mode mode; /* obtained, may be below the requested one */
+};
+
+/* Mode named by HUGE_PAGE_ENV, HUGE_NONE when unset or unknown. */
+enum huge_mode huge_mode_env(void);
+
+const char *huge_mode_name(enum huge_mode mode);
+
+/* Huge page size of the system in bytes, 2 MB when it cannot be read. */
+size_t huge_page_size(void);
+
+/*
+ * Maps size bytes of zeroed memory with mode or, if that fails, the modes
+ * below it. Returns 0 on success.
+ */
+int huge_alloc(struct huge_buf *buf, size_t size, enum huge_mode mode);
+void huge_free(struct huge_buf *buf);
+
+/*
+ * Bytes of buf which are backed by huge pages right now, from
+ * /proc/self/smaps, 0 when that is not readable.
+ */
+size_t huge_backed(const struct huge_buf *buf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
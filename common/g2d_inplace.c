@@ -0,0 +1,114 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_inplace.c
+ *
+ * @brief Symmetric blits done in place, source and destination aliasing
+ *
+ */
+
+#include "g2d.h"
+#include "g2d_format.h"
+#include "g2d_inplace.h"
+
+#include "g2d_alloc_stats.h"
+#include "g2d_trace.h"
+
+int inplace_supported(const struct g2d_surface *src,
+                      const struct g2d_surface *dst) {
+  const struct format_desc *s = format_find(src->format);
+  const struct format_desc *d = format_find(dst->format);
+
+  if (!s || !d || s->planes != 1 || d->planes != 1 || s->bpp[0] != d->bpp[0])
+    return 0;
+  if (src->planes[0] != dst->planes[0] || src->stride != dst->stride ||
+      src->left != dst->left || src->top != dst->top ||
+      src->right != dst->right || src->bottom != dst->bottom)
+    return 0;
+  if (src->rot != G2D_ROTATION_0)
+    return 0;
+
+  switch (dst->rot) {
+  case G2D_ROTATION_0:
+  case G2D_ROTATION_180:
+  case G2D_FLIP_H:
+  case G2D_FLIP_V:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+int inplace_bounce_size(const struct g2d_surface *surface) {
+  return (surface->right - surface->left) * format_bpp(surface->format) / 8 *
+         2 * INPLACE_BAND;
+}
+
+/*
+ * Blits rows from y of from to rows from ty of to, rotated by rot. Returns
+ * the result of g2d_blit or g2d_finish.
+ */
+static int inplace_band(void *handle, const struct g2d_surface *from, int y,
+                         const struct g2d_surface *to, int ty, int rows,
+                         enum g2d_rotation rot) {
+  struct g2d_surface s = *from, d = *to;
+
+  s.top = y;
+  s.bottom = y + rows;
+  s.rot = G2D_ROTATION_0;
+  d.top = ty;
+  d.bottom = ty + rows;
+  d.rot = rot;
+  if (g2d_blit(handle, &s, &d))
+    return -1;
+  return g2d_finish(handle);
+}
+
+int inplace_blit(void *handle, const struct g2d_surface *src,
+                 const struct g2d_surface *dst, struct g2d_buf *bounce) {
+  struct g2d_surface tmp = *src;
+  int top = src->top, bottom = src->bottom, y, rows;
+
+  if (!inplace_supported(src, dst) || !bounce ||
+      bounce->buf_size < inplace_bounce_size(src))
+    return -1;
+
+  tmp.planes[0] = bounce->buf_paddr;
+  tmp.planes[1] = tmp.planes[2] = 0;
+  tmp.left = 0;
+  tmp.right = tmp.width = tmp.stride = src->right - src->left;
+  tmp.top = 0;
+  tmp.bottom = tmp.height = 2 * INPLACE_BAND;
+
+  /*
+   * Mirrored rows: save the top band, mirror the bottom band onto it, then
+   * the saved one onto the bottom, closing in on the middle.
+   */
+  if (dst->rot == G2D_ROTATION_180 || dst->rot == G2D_FLIP_V) {
+    while (bottom - top >= 2 * INPLACE_BAND) {
+      if (inplace_band(handle, src, top, &tmp, 0, INPLACE_BAND,
+                       G2D_ROTATION_0) ||
+          inplace_band(handle, src, bottom - INPLACE_BAND, dst, top,
+                       INPLACE_BAND, dst->rot) ||
+          inplace_band(handle, &tmp, 0, dst, bottom - INPLACE_BAND,
+                       INPLACE_BAND, dst->rot))
+        return -1;
+      top += INPLACE_BAND;
+      bottom -= INPLACE_BAND;
+    }
+  }
+
+  /* the other rows are their own mirror, or the operation keeps them */
+  for (y = top; y < bottom; y += rows) {
+    rows = bottom - y < 2 * INPLACE_BAND ? bottom - y : 2 * INPLACE_BAND;
+    if (inplace_band(handle, src, y, &tmp, 0, rows, G2D_ROTATION_0) ||
+        inplace_band(handle, &tmp, 0, dst, y, rows, dst->rot))
+      return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_inplace.h
+ *
+ * @brief Symmetric blits done in place, source and destination aliasing
+ *
+ * A 180 degree rotation, a horizontal or vertical flip, a swizzle between
+ * formats of the same bpp (RGBA8888 to BGRA8888) or a reorder of packed
+ * YUV (YUYV to UYVY) keeps the size of the frame, so the result can replace
+ * the source instead of needing a second frame. g2d does not define a blit
+ * whose source and destination overlap, the engine may read a pixel after
+ * it was written, so inplace_blit moves the frame band by band through a
+ * bounce buffer of a few rows: mirrored rows swap a top and a bottom band,
+ * the other operations rewrite each band onto itself. Each step finishes
+ * before the next one reads what it wrote.
+ */
+
+#ifndef __G2D_INPLACE_H__
+#define __G2D_INPLACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+
+/* Rows moved per step, the bounce buffer holds two bands. */
+#define INPLACE_BAND 64
+
+/*
+ * Returns 1 if the blit of src to dst can be done in place: the same plane
+ * and rectangle, single plane formats of the same bpp, src not rotated and
+ * dst rotated by 0 or 180 degrees or flipped.
+ */
+int inplace_supported(const struct g2d_surface *src,
+                      const struct g2d_surface *dst);
+
+/* Size in bytes of the bounce buffer for a blit of surface. */
+int inplace_bounce_size(const struct g2d_surface *surface);
+
+/*
+ * Blits src to dst, which alias, through bounce and waits for the result.
+ * Returns -1, doing nothing, if the blit is not supported in place or
+ * bounce is too small, and -1 at the first band g2d fails to blit, leaving
+ * dst partly rewritten.
+ */
+int inplace_blit(void *handle, const struct g2d_surface *src,
+                 const struct g2d_surface *dst, struct g2d_buf *bounce);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
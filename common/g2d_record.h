@@ -0,0 +1,159 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_record.h
+ *
+ * @brief Binary format of the g2d API traces written by libg2d_record.so
+ *
+ * A trace is a record_file_header followed by records. Each record is a
+ * record_header followed by size bytes of payload, whose layout depends on
+ * the op. All fields are in the byte order of the recording target.
+ *
+ * Buffers are identified by the id given when they were created (g2d_alloc,
+ * g2d_buf_from_fd, g2d_buf_from_virt_addr); 0 is a buffer created outside
+ * of the recording. Surfaces keep the physical plane addresses of the
+ * recording, which map back to a buffer through its paddr and size.
+ */
+
+#ifndef __G2D_RECORD_H__
+#define __G2D_RECORD_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RECORD_MAGIC "G2DREC01"
+#define RECORD_VERSION 1
+
+enum record_op {
+  REC_OPEN = 1,           /* no payload, handle is the opened one */
+  REC_CLOSE,              /* no payload */
+  REC_MAKE_CURRENT,       /* record_value */
+  REC_CLEAR,              /* record_surface */
+  REC_BLIT,               /* record_surface src, dst */
+  REC_BLITEX,             /* record_surfaceEx src, dst */
+  REC_COPY,               /* record_copy */
+  REC_MULTI_BLIT,         /* record_multi_blit, layers * (src, dst) */
+  REC_QUERY_HARDWARE,     /* record_value */
+  REC_QUERY_FEATURE,      /* record_value */
+  REC_QUERY_CAP,          /* record_value */
+  REC_ENABLE,             /* record_value */
+  REC_DISABLE,            /* record_value */
+  REC_CACHE_OP,           /* record_buf_ref, arg is the cache mode */
+  REC_ALLOC,              /* record_buffer */
+  REC_BUF_FROM_FD,        /* record_buffer */
+  REC_BUF_EXPORT_FD,      /* record_buf_ref, ret is the fd */
+  REC_BUF_FROM_VIRT_ADDR, /* record_buffer */
+  REC_FREE,               /* record_buf_ref */
+  REC_FLUSH,              /* no payload */
+  REC_FINISH,             /* no payload */
+  REC_SET_WARP_COORDINATES, /* record_warp */
+  REC_SNAPSHOT,           /* record_snapshot, then size bytes of content */
+  REC_OP_COUNT,
+};
+
+struct record_file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size; /* sizeof(struct record_header) */
+  uint64_t start_ns;    /* CLOCK_MONOTONIC at the start of the recording */
+};
+
+struct record_header {
+  uint32_t op;
+  uint32_t size;         /* payload bytes following this header */
+  uint64_t handle;       /* g2d handle the call was made on, 0 if none */
+  uint64_t start_ns;     /* relative to record_file_header.start_ns */
+  uint64_t duration_ns;  /* time spent in libg2d */
+  uint32_t tid;
+  int32_t ret;
+};
+
+struct record_surface {
+  int32_t format;
+  int32_t planes[3];
+  int32_t left;
+  int32_t top;
+  int32_t right;
+  int32_t bottom;
+  int32_t stride;
+  int32_t width;
+  int32_t height;
+  int32_t blendfunc;
+  int32_t global_alpha;
+  int32_t clrcolor;
+  int32_t rot;
+};
+
+struct record_surfaceEx {
+  struct record_surface base;
+  int32_t tiling;
+  uint32_t ts_addr;
+  uint32_t fc_enabled;
+  uint32_t fc_value;
+  uint32_t fc_value_upper;
+};
+
+struct record_buffer {
+  uint32_t id;
+  int32_t size;
+  int32_t cacheable; /* -1 when not known, e.g. imported buffers */
+  int32_t paddr;
+  uint64_t vaddr;
+  int32_t fd;        /* -1 unless imported from a dma-buf fd */
+  int32_t reserved;
+};
+
+struct record_buf_ref {
+  uint32_t id;
+  int32_t arg;
+};
+
+struct record_copy {
+  uint32_t dst;
+  uint32_t src;
+  int32_t size;
+  int32_t reserved;
+};
+
+struct record_value {
+  int32_t arg;    /* hardware type, feature or capability */
+  int32_t result; /* value returned through the pointer argument, if any */
+};
+
+struct record_multi_blit {
+  int32_t layers;
+  int32_t reserved;
+};
+
+struct record_warp {
+  int32_t addr;
+  uint32_t width;
+  uint32_t height;
+  int32_t format;
+  uint32_t bpp;
+  uint32_t arb_start_x;
+  uint32_t arb_start_y;
+  uint8_t arb_delta_xx;
+  uint8_t arb_delta_xy;
+  uint8_t arb_delta_yx;
+  uint8_t arb_delta_yy;
+};
+
+struct record_snapshot {
+  uint32_t id;
+  int32_t size;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
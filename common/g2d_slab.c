@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_slab.c
+ *
+ * @brief Many surfaces sub-allocated from one g2d buffer
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "g2d.h"
+#include "g2d_bench.h"
+#include "g2d_slab.h"
+
+#include "g2d_alloc_stats.h"
+#include "g2d_trace.h"
+
+static int slab_round(int size, int align) {
+  return (size + align - 1) / align * align;
+}
+
+void slab_init(struct g2d_slab *slab) {
+  memset(slab, 0, sizeof(*slab));
+  slab->separate_ns = -1;
+}
+
+struct g2d_buf *slab_reserve(struct g2d_slab *slab, int size, int align) {
+  struct g2d_buf *view;
+  int offset;
+
+  if (slab->buf || slab->count == SLAB_MAX_SURFACES || size <= 0) {
+    printf("slab: cannot reserve %d bytes, %d surfaces%s\n", size,
+           slab->count, slab->buf ? " already committed" : "");
+    return NULL;
+  }
+  if (align < SLAB_ALIGN)
+    align = SLAB_ALIGN;
+
+  offset = slab_round(slab->size, align);
+  slab->padding += offset - slab->size;
+  slab->offset[slab->count] = offset;
+  slab->size = offset + size;
+
+  view = &slab->views[slab->count++];
+  memset(view, 0, sizeof(*view));
+  view->buf_size = size;
+  return view;
+}
+
+struct g2d_buf *slab_reserve_surface(struct g2d_slab *slab,
+                                     const struct g2d_surface *surface,
+                                     struct format_layout *layout) {
+  if (format_layout(surface->format, surface->stride, surface->height, 0,
+                    layout)) {
+    printf("format %d has no plane layout\n", surface->format);
+    return NULL;
+  }
+  return slab_reserve(slab, layout->total, layout->desc->align);
+}
+
+long long slab_time_separate(struct g2d_slab *slab, int cacheable) {
+  struct g2d_buf *bufs[SLAB_MAX_SURFACES];
+  long long start = bench_get_time_ns(), ns;
+  int i, n;
+
+  for (n = 0; n < slab->count; n++) {
+    bufs[n] = g2d_alloc(slab->views[n].buf_size, cacheable);
+    if (!bufs[n])
+      break;
+  }
+  ns = bench_get_time_ns() - start;
+  for (i = 0; i < n; i++)
+    g2d_free(bufs[i]);
+
+  slab->separate_ns = n == slab->count ? ns : -1;
+  return slab->separate_ns;
+}
+
+int slab_commit(struct g2d_slab *slab, int cacheable) {
+  long long start = bench_get_time_ns();
+  int i;
+
+  if (slab->buf || !slab->count)
+    return -1;
+
+  slab->buf = g2d_alloc(slab->size, cacheable);
+  slab->alloc_ns = bench_get_time_ns() - start;
+  if (!slab->buf) {
+    printf("Fail to allocate a %d bytes slab for %d surfaces\n", slab->size,
+           slab->count);
+    return -1;
+  }
+
+  for (i = 0; i < slab->count; i++) {
+    slab->views[i].buf_handle = slab->buf->buf_handle;
+    slab->views[i].buf_vaddr = (char *)slab->buf->buf_vaddr + slab->offset[i];
+    slab->views[i].buf_paddr = slab->buf->buf_paddr + slab->offset[i];
+  }
+  return 0;
+}
+
+void slab_free(struct g2d_slab *slab) {
+  if (slab->buf)
+    g2d_free(slab->buf);
+  slab_init(slab);
+}
+
+void slab_report(const struct g2d_slab *slab, const char *name) {
+  int page = sysconf(_SC_PAGESIZE);
+  long long separate = 0;
+  int i;
+
+  for (i = 0; i < slab->count; i++)
+    separate += slab_round(slab->views[i].buf_size, page);
+
+  printf("%s slab: %d surfaces in %d bytes, %d bytes alignment padding\n",
+         name, slab->count, slab_round(slab->size, page), slab->padding);
+  printf("%s slab: %lld bytes as separate buffers, %lld bytes saved\n", name,
+         separate, separate - slab_round(slab->size, page));
+  if (slab->separate_ns >= 0)
+    printf("%s slab: 1 g2d_alloc %.1fus, %d separate g2d_alloc %.1fus\n", name,
+           slab->alloc_ns / 1e3, slab->count, slab->separate_ns / 1e3);
+  else
+    printf("%s slab: 1 g2d_alloc %.1fus\n", name, slab->alloc_ns / 1e3);
+}
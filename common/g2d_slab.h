@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_slab.h
+ *
+ * @brief Many surfaces sub-allocated from one g2d buffer
+ *
+ * Each g2d_alloc is a separate contiguous allocation from the driver, paid
+ * in time and rounded up to whole pages. A slab instead collects the sizes
+ * of every surface with slab_reserve, then makes one g2d_alloc for all of
+ * them in slab_commit. Each reservation is a struct g2d_buf view into the
+ * slab whose buf_vaddr and buf_paddr are valid once the slab is committed,
+ * so it can be used wherever a g2d buffer is, format_set_planes included.
+ *
+ * Views belong to the slab: they are never passed to g2d_free, and a cache
+ * operation on a view applies to the whole slab. Offsets are aligned to
+ * the alignment of the surface format and at least to a cache line, so two
+ * surfaces never share a line of a cacheable slab.
+ */
+
+#ifndef __G2D_SLAB_H__
+#define __G2D_SLAB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+#include "g2d_format.h"
+
+#define SLAB_MAX_SURFACES 32
+
+/* Minimum alignment of a surface in the slab, a cache line. */
+#define SLAB_ALIGN 64
+
+struct g2d_slab {
+  struct g2d_buf *buf; /* NULL until slab_commit */
+  struct g2d_buf views[SLAB_MAX_SURFACES];
+  int offset[SLAB_MAX_SURFACES];
+  int count;
+  int size;              /* bytes reserved, padding included */
+  int padding;           /* bytes lost to alignment */
+  long long alloc_ns;    /* the g2d_alloc of slab_commit */
+  long long separate_ns; /* slab_time_separate, -1 when not measured */
+};
+
+void slab_init(struct g2d_slab *slab);
+
+/*
+ * Reserves size bytes aligned to align, SLAB_ALIGN when smaller. Returns
+ * the view, whose addresses are set by slab_commit, or NULL when the slab
+ * is committed or full.
+ */
+struct g2d_buf *slab_reserve(struct g2d_slab *slab, int size, int align);
+
+/*
+ * Reserves the planes of surface, laid out by format_layout with the
+ * alignment of its format. Once committed, format_set_planes(surface, view,
+ * layout) sets the plane addresses.
+ */
+struct g2d_buf *slab_reserve_surface(struct g2d_slab *slab,
+                                     const struct g2d_surface *surface,
+                                     struct format_layout *layout);
+
+/*
+ * Times allocating every reservation with its own g2d_alloc, as without
+ * the slab, and frees them again. Called before slab_commit, it returns
+ * the time in ns, or -1 if an allocation failed.
+ */
+long long slab_time_separate(struct g2d_slab *slab, int cacheable);
+
+/* Makes the one g2d_alloc and sets the views. Returns 0 on success. */
+int slab_commit(struct g2d_slab *slab, int cacheable);
+
+/* Frees the slab, the views are no longer valid. */
+void slab_free(struct g2d_slab *slab);
+
+/*
+ * Prints the footprint of the slab against the page rounded sum of the
+ * separate buffers, and both allocation times when measured.
+ */
+void slab_report(const struct g2d_slab *slab, const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
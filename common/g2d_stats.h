@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_stats.h
+ *
+ * @brief Layout of the live g2d statistics shared by libg2d_prof.so
+ *
+ * With G2D_STATS_SHM set, libg2d_prof.so keeps its counters in the POSIX
+ * shared memory object STATS_SHM_PREFIX<pid> instead of private memory, so
+ * that g2d_top can watch a running application. The counters only grow and
+ * are updated with relaxed atomics, readers take deltas between two reads.
+ */
+
+#ifndef __G2D_STATS_H__
+#define __G2D_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STATS_SHM_ENV "G2D_STATS_SHM"
+#define STATS_SHM_PREFIX "/g2d_stats."
+
+#define STATS_MAGIC 0x53443247 /* "G2DS" */
+#define STATS_VERSION 1
+
+#define STATS_NAME_LEN 32
+#define STATS_MAX_FUNCS 32
+
+/* log2 latency buckets: < 1us, < 2us, < 4us ... the last one is open */
+#define STATS_BUCKETS 24
+
+/* Reader and writer run on the same target, long long is 64 bits there. */
+struct stats_counter {
+  char name[STATS_NAME_LEN];
+  unsigned long long calls;
+  unsigned long long total_ns;
+  unsigned long long min_ns;
+  unsigned long long max_ns;
+  unsigned long long pixels;
+  unsigned long long bytes;
+  unsigned long long hist[STATS_BUCKETS];
+};
+
+struct stats_block {
+  uint32_t magic;
+  uint32_t version;
+  int32_t pid;
+  int32_t func_count;
+  char process[STATS_NAME_LEN];
+  uint64_t start_ns; /* CLOCK_MONOTONIC when the process started */
+  struct stats_counter funcs[STATS_MAX_FUNCS];
+  /* time between two g2d_finish calls, on any handle */
+  struct stats_counter frames;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_trace.c
+ *
+ * @brief Chrome trace / Perfetto JSON writer for the g2d samples
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include "g2d_trace.h"
+
+#define TRACE_BUFFER_SIZE (1024 * 1024)
+
+/* 0: not initialised, 1: initialising, 2: enabled, -1: disabled */
+static volatile int trace_state;
+static FILE *trace_file;
+static int trace_pid;
+
+static double trace_time_us(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static long trace_tid(void) {
+#ifdef __linux__
+  return syscall(SYS_gettid);
+#else
+  return (long)pthread_self();
+#endif
+}
+
+static void trace_write(const char *cat, const char *name, char ph) {
+  /* one fprintf per event, stdio keeps it whole across threads */
+  fprintf(trace_file,
+          "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,"
+          "\"pid\":%d,\"tid\":%ld%s},\n",
+          name, cat, ph, trace_time_us(), trace_pid, trace_tid(),
+          ph == 'i' ? ",\"s\":\"t\"" : "");
+}
+
+static void trace_close(void) {
+  /* JSON array format: a last event without the trailing comma */
+  fprintf(trace_file,
+          "{\"name\":\"trace_end\",\"cat\":\"trace\",\"ph\":\"i\","
+          "\"ts\":%.3f,\"pid\":%d,\"tid\":%ld,\"s\":\"p\"}\n]\n",
+          trace_time_us(), trace_pid, trace_tid());
+  fclose(trace_file);
+  trace_file = NULL;
+  trace_state = -1;
+}
+
+static void trace_init(void) {
+  const char *path = getenv(TRACE_FILE_ENV);
+
+  if (!path || !*path) {
+    trace_state = -1;
+    return;
+  }
+
+  trace_file = fopen(path, "w");
+  if (!trace_file) {
+    printf("FAILED to open trace file %s\n", path);
+    trace_state = -1;
+    return;
+  }
+
+  setvbuf(trace_file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+  trace_pid = getpid();
+  fprintf(trace_file, "[\n");
+  atexit(trace_close);
+
+  __sync_synchronize();
+  trace_state = 2;
+}
+
+int trace_enabled(void) {
+  if (trace_state == 0 && __sync_bool_compare_and_swap(&trace_state, 0, 1))
+    trace_init();
+
+  /* another thread is opening the file */
+  while (trace_state == 1)
+    sched_yield();
+
+  return trace_state == 2;
+}
+
+void trace_begin(const char *cat, const char *name) {
+  if (trace_enabled())
+    trace_write(cat, name, 'B');
+}
+
+void trace_end(const char *cat, const char *name) {
+  if (trace_enabled())
+    trace_write(cat, name, 'E');
+}
+
+void trace_instant(const char *cat, const char *name) {
+  if (trace_enabled())
+    trace_write(cat, name, 'i');
+}
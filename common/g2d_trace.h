@@ -0,0 +1,74 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file g2d_trace.h
+ *
+ * @brief Chrome trace / Perfetto JSON writer for the g2d samples
+ *
+ * Set G2D_TRACE_FILE=<path> to record begin/end events with thread ids,
+ * then open the file in chrome://tracing or ui.perfetto.dev.
+ *
+ * Include this header after g2d.h and g2dExt.h: the g2d entry points listed
+ * below are redefined so that every call is recorded without touching the
+ * call sites. g2d_cache_op is recorded by cache_stats_op(), see
+ * g2d_cache_stats.h, and in a G2D_ALLOC_STATS build g2d_alloc/g2d_free by
+ * the tracker of g2d_alloc_stats.h.
+ */
+
+#ifndef __G2D_TRACE_H__
+#define __G2D_TRACE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "g2d.h"
+#include "g2dExt.h"
+
+/* Environment variable holding the path of the trace file. */
+#define TRACE_FILE_ENV "G2D_TRACE_FILE"
+
+/* Returns 1 once the trace file is open, 0 when tracing is off. */
+int trace_enabled(void);
+
+/* Begin and end events must nest on each thread, like function calls. */
+void trace_begin(const char *cat, const char *name);
+void trace_end(const char *cat, const char *name);
+
+/* A zero duration event, e.g. a frame callback arriving. */
+void trace_instant(const char *cat, const char *name);
+
+#define TRACE_CALL(name, call)                                                 \
+  ({                                                                           \
+    __typeof__(call) trace_ret_;                                               \
+    trace_begin("g2d", name);                                                  \
+    trace_ret_ = (call);                                                       \
+    trace_end("g2d", name);                                                    \
+    trace_ret_;                                                                \
+  })
+
+#define g2d_open(...) TRACE_CALL("g2d_open", g2d_open(__VA_ARGS__))
+#define g2d_close(...) TRACE_CALL("g2d_close", g2d_close(__VA_ARGS__))
+#ifndef G2D_ALLOC_STATS
+#define g2d_alloc(...) TRACE_CALL("g2d_alloc", g2d_alloc(__VA_ARGS__))
+#define g2d_free(...) TRACE_CALL("g2d_free", g2d_free(__VA_ARGS__))
+#endif
+#define g2d_clear(...) TRACE_CALL("g2d_clear", g2d_clear(__VA_ARGS__))
+#define g2d_blit(...) TRACE_CALL("g2d_blit", g2d_blit(__VA_ARGS__))
+#define g2d_blitEx(...) TRACE_CALL("g2d_blitEx", g2d_blitEx(__VA_ARGS__))
+#define g2d_copy(...) TRACE_CALL("g2d_copy", g2d_copy(__VA_ARGS__))
+#define g2d_multi_blit(...)                                                    \
+  TRACE_CALL("g2d_multi_blit", g2d_multi_blit(__VA_ARGS__))
+#define g2d_flush(...) TRACE_CALL("g2d_flush", g2d_flush(__VA_ARGS__))
+#define g2d_finish(...) TRACE_CALL("g2d_finish", g2d_finish(__VA_ARGS__))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
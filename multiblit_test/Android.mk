@@ -4,7 +4,14 @@ include $(LOCAL_PATH)/../../../../driver/Android.mk.def
 # Share library
 include $(CLEAR_VARS)
 LOCAL_SRC_FILES := \
-	g2d_multiblit.c
+	g2d_multiblit.c \
+	../common/g2d_arena.c \
+	../common/g2d_bench.c \
+	../common/g2d_format.c \
+	../common/g2d_slab.c \
+	../common/g2d_trace.c \
+	../common/g2d_cache_stats.c \
+	../common/g2d_alloc_stats.c
 
 LOCAL_CFLAGS += -DBUILD_FOR_ANDROID -DIMX6Q
 
@@ -16,7 +23,7 @@ else
 LOCAL_SHARED_LIBRARIES += libg2d
 endif
 
-LOCAL_C_INCLUDES := $(LOCAL_PATH)
+LOCAL_C_INCLUDES := $(LOCAL_PATH) $(LOCAL_PATH)/../common
 
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../include/ $(FSL_PROPRIETARY_PATH)/fsl-proprietary/include/
 LOCAL_C_INCLUDES += $(AQROOT)/driver/android/gralloc \
@@ -17,18 +17,29 @@
 
 #include <g2dExt.h>
 
+#include "g2d_alloc_stats.h"
+#include "g2d_arena.h"
+#include "g2d_bench.h"
+#include "g2d_format.h"
+#include "g2d_slab.h"
+#include "g2d_trace.h"
+
 #define TEST_WIDTH 1920
 #define TEST_HEIGHT 1080
 #define TEST_BPP 32
 #define TEST_FORMAT "RGBA"
 #define TEST_LOOP 16
 
+/* the surface pairs of every layer, which all sections reuse */
+static unsigned char pair_mem[4096];
+
 int main(void) {
   int i, j, n, diff = 0;
   const int layers = 8;
   void *handle = NULL;
   int g2d_feature_available = 0;
-  struct timeval tv1, tv2;
+  struct bench_section sec;
+  struct bench_run run;
   char test_format[64];
   int test_width, test_height, test_bpp;
   struct g2d_buf *s_buf, *d_buf;
@@ -37,10 +48,15 @@ int main(void) {
   struct g2d_surface src, dst;
   struct g2d_surface mul_src[layers], mul_dst[layers];
 
+  struct frame_arena arena;
+  long long heap_allocs;
+  struct g2d_slab slab;
+  struct format_layout layout;
+
   struct g2d_surface_pair *sp[layers];
+  arena_init(&arena, pair_mem, sizeof(pair_mem));
   for (n = 0; n < layers; n++) {
-    sp[n] = (struct g2d_surface_pair *)malloc(sizeof(struct g2d_surface_pair) *
-                                              layers);
+    sp[n] = ARENA_NEW(&arena, struct g2d_surface_pair, 1);
   }
 
   //---------- g2d open -------------
@@ -48,6 +64,7 @@ int main(void) {
     printf("g2d_open fail.\n");
     return -ENOTTY;
   }
+  bench_run_init(&run, TEST_LOOP);
 
   //---------- g2d alloc -------------
   test_width = TEST_WIDTH;
@@ -63,9 +80,25 @@ int main(void) {
   s_buf = g2d_alloc(test_width * test_height * 4, 0);
   d_buf = g2d_alloc(test_width * test_height * 4, 0);
 
+  /* the layer sources share one allocation */
+  slab_init(&slab);
   for (n = 0; n < layers; n++) {
-    mul_s_buf[n] = g2d_alloc(test_width * test_height * 4, 0);
-  }
+    mul_src[n].format = G2D_RGBA8888;
+    mul_src[n].stride = test_width;
+    mul_src[n].height = test_height;
+    mul_s_buf[n] = slab_reserve_surface(&slab, &mul_src[n], &layout);
+  }
+  slab_time_separate(&slab, 0);
+  if (slab_commit(&slab, 0)) {
+    if (s_buf)
+      g2d_free(s_buf);
+    if (d_buf)
+      g2d_free(d_buf);
+    g2d_close(handle);
+    return -ENOMEM;
+  }
+  slab_report(&slab, "layer source");
+  heap_allocs = alloc_stats_heap_allocs();
 
   //---------- g2d blit -------------
   printf("\n----- g2d blit -----\n");
@@ -96,24 +129,25 @@ int main(void) {
 
   *((int *)((long)s_buf->buf_vaddr)) = 0x1a2b3c4d;
   *((int *)((long)d_buf->buf_vaddr)) = 0x0;
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_blit(handle, &src, &dst);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
+  bench_section_end(&sec);
 
   if (*((int *)s_buf->buf_vaddr) != *((int *)d_buf->buf_vaddr)) {
     printf("g2d blit fail!!!\n");
   }
 
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("g2d blit time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /*--- g2d blit with multiblit */
   printf("\n--- g2d blit with multiblit ---\n");
@@ -129,49 +163,52 @@ int main(void) {
     sp[n]->d = dst;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("g2d multiblit 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       "g2d multiblit 4 layers time %dus, %dfps, %d(4 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 4,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 8);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       "g2d multiblit 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 8,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   if (*((int *)s_buf->buf_vaddr) != *((int *)d_buf->buf_vaddr)) {
     printf("\ng2d multi blit fail!!!\n");
@@ -250,17 +287,16 @@ int main(void) {
     sp[n]->d.bottom = test_height;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -280,6 +316,8 @@ int main(void) {
       "  0 rotation 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 8,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   for (n = 0; n < layers; n++) {
     sp[n]->s.left = 0;
@@ -288,29 +326,31 @@ int main(void) {
     sp[n]->s.bottom = test_height;
   }
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       "  0 rotation 4 layers time %dus, %dfps, %d(4 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 4,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("  0 rotation 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /* -------- 90 DEGREE ------------*/
   for (i = 0; i < test_width; i++) {
@@ -349,18 +389,17 @@ int main(void) {
     sp[n]->d.planes[0] = d_buf->buf_paddr;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
+  bench_section_end(&sec);
 
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -379,30 +418,34 @@ int main(void) {
       "\n 90 rotation 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 8,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       " 90 rotation 4 layers time %dus, %dfps, %d(4 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 4,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(" 90 rotation 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /*--- 180 DEGREE ----*/
   test_width = 1920;
@@ -443,17 +486,16 @@ int main(void) {
     sp[n]->d.planes[0] = d_buf->buf_paddr;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -475,30 +517,34 @@ int main(void) {
       "\n180 rotation 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 8,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       "180 rotation 4 layers time %dus, %dfps, %d(4 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 4,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("180 rotation 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /*--- 270 DEGREE ---*/
   test_width = 1920;
@@ -543,17 +589,16 @@ int main(void) {
     sp[n]->d = sp[0]->d;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -573,30 +618,34 @@ int main(void) {
       "\n270 rotation 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 8,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf(
       "270 rotation 4 layers time %dus, %dfps, %d(4 * %d)Mpixel/s ........\n",
       diff, 1000000 / diff, test_width * test_height / diff * 4,
       test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("270 rotation 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /*--- flip H ---*/
   test_width = 1920;
@@ -637,17 +686,16 @@ int main(void) {
     sp[n]->d.planes[0] = d_buf->buf_paddr;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -665,6 +713,8 @@ int main(void) {
   printf("\nflip h 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff * 8,
          test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /*--- flip v ---*/
   memset(d_buf->buf_vaddr, 0xcd, test_width * test_height * 4);
@@ -699,17 +749,16 @@ int main(void) {
     sp[n]->d = sp[0]->d;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -727,6 +776,8 @@ int main(void) {
   printf("flip v 8 layers time %dus, %dfps, %d(8 * %d)Mpixel/s ........\n",
          diff, 1000000 / diff, test_width * test_height / diff * 8,
          test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /**/
   /*-------------------------------------*/
@@ -773,17 +824,16 @@ int main(void) {
     sp[n]->d = dst;
   }
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, layers);
   }
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   for (i = 0; i < test_height / 2; i++) {
     for (j = 0; j < test_width; j++) {
@@ -807,32 +857,36 @@ int main(void) {
   }
   printf("rgb to yuv 8 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("rgb to yuv 4 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   printf("rgb to yuv 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   /**/
   /*--------------------------------------------------------------------*/
@@ -908,16 +962,15 @@ int main(void) {
 
   g2d_enable(handle, G2D_BLEND);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 8);
   }
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
 
   g2d_disable(handle, G2D_BLEND);
 
@@ -931,32 +984,36 @@ int main(void) {
   }
   printf("\nmode 1, 8 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 4);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   g2d_disable(handle, G2D_BLEND);
   printf("mode 1, 4 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
-  for (i = 0; i < TEST_LOOP; i++) {
+  bench_section_begin(&sec);
+  while (bench_run_next(&run, handle)) {
     g2d_multi_blit(handle, sp, 1);
   }
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  bench_section_end(&sec);
+  diff = bench_run_us(&run, sec.elapsed_us);
   g2d_disable(handle, G2D_BLEND);
   printf("mode 1, 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, run.count);
+  bench_run_report(&run);
 
   memset(d_buf->buf_vaddr, 0x64, test_width * test_height * 4);
   sp[0]->s.blendfunc = G2D_ONE;
@@ -972,15 +1029,14 @@ int main(void) {
 
   g2d_enable(handle, G2D_BLEND);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   g2d_multi_blit(handle, sp, 8);
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
 
   g2d_disable(handle, G2D_BLEND);
 
@@ -1003,28 +1059,29 @@ int main(void) {
   }
   printf("\nmode 2, 8 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 4);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
   g2d_disable(handle, G2D_BLEND);
   printf("mode 2, 4 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 1);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
   g2d_disable(handle, G2D_BLEND);
   printf("mode 2, 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   memset(d_buf->buf_vaddr, 0x64, test_width * test_height * 4);
   sp[0]->s.blendfunc = G2D_ONE;
@@ -1120,17 +1177,16 @@ int main(void) {
 
   g2d_enable(handle, G2D_BLEND);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   g2d_multi_blit(handle, sp, 8);
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
+  bench_section_end(&sec);
 
   g2d_disable(handle, G2D_BLEND);
 
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  diff = sec.elapsed_us;
 
   for (i = 0; i < test_height; i++) {
     for (j = 0; j < test_width; j++) {
@@ -1143,28 +1199,29 @@ int main(void) {
   }
   printf("\nmode 5, 8 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 4);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
+  bench_section_end(&sec);
   g2d_disable(handle, G2D_BLEND);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  diff = sec.elapsed_us;
   printf("mode 5, 4 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 1);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
+  bench_section_end(&sec);
   g2d_disable(handle, G2D_BLEND);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  diff = sec.elapsed_us;
   printf("mode 5, 1 layers time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   /* Test global alpha */
   printf("\n\n--- TEST GLOBAL ALPHA ---\n");
@@ -1212,15 +1269,14 @@ int main(void) {
   g2d_enable(handle, G2D_BLEND);
   g2d_enable(handle, G2D_GLOBAL_ALPHA);
 
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
 
   g2d_multi_blit(handle, sp, 1);
 
   g2d_finish(handle);
 
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
 
   g2d_disable(handle, G2D_GLOBAL_ALPHA);
   g2d_disable(handle, G2D_BLEND);
@@ -1239,37 +1295,43 @@ int main(void) {
   }
   printf("global alpha 1 layer time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
   g2d_enable(handle, G2D_GLOBAL_ALPHA);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 4);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
   g2d_disable(handle, G2D_GLOBAL_ALPHA);
   g2d_disable(handle, G2D_BLEND);
   printf("global alpha 4 layer time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   g2d_enable(handle, G2D_BLEND);
   g2d_enable(handle, G2D_GLOBAL_ALPHA);
-  gettimeofday(&tv1, NULL);
+  bench_section_begin(&sec);
   g2d_multi_blit(handle, sp, 8);
   g2d_finish(handle);
-  gettimeofday(&tv2, NULL);
-  diff =
-      ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) / 1;
+  bench_section_end(&sec);
+  diff = sec.elapsed_us;
   g2d_disable(handle, G2D_GLOBAL_ALPHA);
   g2d_disable(handle, G2D_BLEND);
   printf("global alpha 8 layer time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_section_report(&sec, 1);
 
   //---------------------------
 FAIL:
-  for (n = 0; n < layers; n++)
-    g2d_free(mul_s_buf[n]);
+  if (ALLOC_STATS_TRACKING)
+    printf("\nheap allocations after setup: %lld\n",
+           alloc_stats_heap_allocs() - heap_allocs);
+  arena_reset(&arena);
+  arena_report(&arena, "surface pair");
+
+  slab_free(&slab);
   g2d_free(s_buf);
   g2d_free(d_buf);
 
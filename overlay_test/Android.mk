@@ -4,7 +4,16 @@ LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 LOCAL_SRC_FILES := \
 	g2d_overlay.c \
-	../os/linux/gfx_fbdev.c
+	../os/linux/gfx_fbdev.c \
+	../common/g2d_arena.c \
+	../common/g2d_asset.c \
+	../common/g2d_cache_policy.c \
+	../common/g2d_bench.c \
+	../common/g2d_format.c \
+	../common/g2d_slab.c \
+	../common/g2d_trace.c \
+	../common/g2d_cache_stats.c \
+	../common/g2d_alloc_stats.c
 
 LOCAL_CFLAGS += -DBUILD_FOR_ANDROID -DIMX6Q -Wno-implicit-function-declaration
 
@@ -16,7 +25,7 @@ else
 LOCAL_SHARED_LIBRARIES += libg2d
 endif
 
-LOCAL_C_INCLUDES := $(LOCAL_PATH)
+LOCAL_C_INCLUDES := $(LOCAL_PATH) $(LOCAL_PATH)/../common
 
 LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)../os/linux \
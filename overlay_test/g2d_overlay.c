@@ -33,13 +33,18 @@ extern "C" {
 #include <unistd.h>
 
 #include "g2d.h"
+#include "g2d_alloc_stats.h"
+#include "g2d_arena.h"
+#include "g2d_asset.h"
+#include "g2d_cache_stats.h"
+#include "g2d_format.h"
+#include "g2d_slab.h"
+#include "g2d_trace.h"
 #include "gfx_init.h"
 
 #define TFAIL -1
 #define TPASS 0
 
-#define CACHEABLE 0
-
 int g_buf_size;
 int g_buf_phys;
 
@@ -57,41 +62,64 @@ struct img_info {
   struct g2d_buf *img_ptr;
 };
 
-struct g2d_buf *createG2DTextureBuf(char *filename) {
-  FILE *stream = NULL;
-  int size = 0;
-  struct g2d_buf *buf = NULL;
-  int len = 0;
-
-  stream = fopen(filename, "rb");
-  if (!stream) {
-    printf("Fail to open data file %s\n", filename);
-    return NULL;
+/* 8 image records and 8 surface pairs per multiblit frame, with room */
+#define MULTIBLIT_ARENA_SIZE 4096
+/* frames drawn again after the timed one to check the steady state */
+#define MULTIBLIT_FRAMES 8
+
+static unsigned char multiblit_mem[MULTIBLIT_ARENA_SIZE];
+static struct frame_arena multiblit_arena;
+
+/* g2dDataBuf[i] holds the content of asset_files[i] */
+static const char *asset_files[] = {
+    "1024x768-rgb565.rgb", "800x600-bgr565.rgb", "480x360-bgr565.rgb",
+    "176x144-yuv420p.yuv", "352x288-nv16.yuv",   "352x288-yuyv.yuv"};
+#define ASSET_COUNT (int)(sizeof(asset_files) / sizeof(asset_files[0]))
+
+static struct g2d_slab asset_slab;
+
+/* Copies every asset into one slab, bufs[i] being the view of asset i. */
+static int load_assets(struct g2d_buf *bufs[]) {
+  struct asset_map maps[ASSET_COUNT];
+  int i, mapped, cacheable, ret = -1;
+
+  trace_begin("io", "load");
+  slab_init(&asset_slab);
+  for (mapped = 0; mapped < ASSET_COUNT; mapped++)
+    if (asset_map(asset_files[mapped], &maps[mapped]))
+      goto out;
+
+  for (i = 0; i < ASSET_COUNT; i++) {
+    bufs[i] = slab_reserve(&asset_slab, maps[i].size, 0);
+    if (!bufs[i])
+      goto out;
   }
-
-  fseek(stream, 0, SEEK_END);
-  size = ftell(stream);
-
-  fseek(stream, 0L, SEEK_SET);
-
-  // alloc physical contiguous memory for source image data
-  buf = g2d_alloc(size, CACHEABLE);
-  if (buf) {
-    len = fread((void *)buf->buf_vaddr, 1, size, stream);
-    if (len != size)
-      printf("fread %s error\n", filename);
-
-#if CACHEABLE
-    g2d_cache_op(buf, G2D_CACHE_FLUSH);
-#endif
+  cacheable = cache_policy_cacheable(asset_slab.size, CACHE_CPU_WRITE_ONCE);
+  slab_time_separate(&asset_slab, cacheable);
+  if (slab_commit(&asset_slab, cacheable))
+    goto out;
+
+  for (i = 0; i < ASSET_COUNT; i++) {
+    asset_copy(&maps[i], bufs[i]->buf_vaddr, 0, maps[i].size);
+    asset_report(asset_files[i], &maps[i], 0);
   }
-
-  fclose(stream);
-  return buf;
+  if (cacheable)
+    g2d_cache_op(asset_slab.buf, G2D_CACHE_CLEAN);
+  slab_report(&asset_slab, "asset");
+  ret = 0;
+
+out:
+  for (i = 0; i < mapped; i++)
+    asset_unmap(&maps[i]);
+  if (ret) {
+    slab_free(&asset_slab);
+    for (i = 0; i < ASSET_COUNT; i++)
+      bufs[i] = NULL;
+  }
+  trace_end("io", "load");
+  return ret;
 }
 
-void releaseG2DTextureBuf(struct g2d_buf *buf) { g2d_free(buf); }
-
 static void draw_image_to_framebuffer(void *handle, struct g2d_buf *buf,
                                       int img_width, int img_height,
                                       int img_size, int img_format,
@@ -101,6 +129,7 @@ static void draw_image_to_framebuffer(void *handle, struct g2d_buf *buf,
                                       int rotation, int set_blur) {
   int i;
   struct g2d_surface src, dst;
+  struct format_layout layout;
 
   if (((left + dst_width) > (int)screen_info->xres) ||
       ((top + dst_height) > (int)screen_info->yres)) {
@@ -109,49 +138,22 @@ static void draw_image_to_framebuffer(void *handle, struct g2d_buf *buf,
   }
 
   /*
-  NOTE: in this example, all the test image data meet with the alignment
-  requirement. Thus, in your code, you need to pay attention on that.
-
-  Pixel buffer address alignment requirement,
-  RGB/BGR: pixel data in planes [0] with 16bytes alignment,
-  NV12/NV16: Y in planes [0], UV in planes [1], with 64bytes alignment,
-  I420: Y in planes [0], U in planes [1], V in planes [2], with 64 bytes
-  alignment,
-  YV12: Y in planes [0], V in planes [1], U in planes [2], with 64 bytes
-  alignment,
-  NV21/NV61: Y in planes [0], VU in planes [1], with 64bytes alignment,
-  YUYV/YVYU/UYVY/VYUY: in planes[0], buffer address is with 16bytes alignment.
+  The raw test images hold their planes back to back. g2d_format.h gives the
+  plane address alignment each format requires, 16 bytes for RGB and packed
+  YUV and 64 bytes for each plane of NV12/NV16/I420, which the test images
+  meet. In your code, lay out the planes with format_alloc instead.
   */
 
   src.format = img_format;
-  switch (src.format) {
-  case G2D_RGB565:
-  case G2D_RGBA8888:
-  case G2D_RGBX8888:
-  case G2D_BGRA8888:
-  case G2D_BGRX8888:
-  case G2D_BGR565:
-  case G2D_YUYV:
-  case G2D_UYVY:
-    src.planes[0] = buf->buf_paddr;
-    break;
-  case G2D_NV12:
-    src.planes[0] = buf->buf_paddr;
-    src.planes[1] = buf->buf_paddr + img_width * img_height;
-    break;
-  case G2D_I420:
-    src.planes[0] = buf->buf_paddr;
-    src.planes[1] = buf->buf_paddr + img_width * img_height;
-    src.planes[2] = src.planes[1] + img_width * img_height / 4;
-    break;
-  case G2D_NV16:
-    src.planes[0] = buf->buf_paddr;
-    src.planes[1] = buf->buf_paddr + img_width * img_height;
-    break;
-  default:
+  if (format_layout(src.format, img_width, img_height, FORMAT_PACKED,
+                    &layout)) {
     printf("Unsupport source image format in the example code\n");
     return;
   }
+  if (!layout.aligned)
+    printf("%s image planes are not %d bytes aligned, off the fast path\n",
+           layout.desc->name, layout.desc->align);
+  format_set_planes(&src, buf, &layout);
 
   src.left = 0;
   src.top = 0;
@@ -210,12 +212,17 @@ static void draw_image_with_multiblit(void *handle,
                                       screeninfo_t *screen_info) {
   int i, n;
   struct g2d_surface_pair *sp[layers];
+  struct g2d_surface_pair *pairs;
+  struct format_layout layout;
   struct g2d_buf *buf;
 
-  for (n = 0; n < layers; n++) {
-    sp[n] = (struct g2d_surface_pair *)malloc(sizeof(struct g2d_surface_pair) *
-                                              layers);
+  pairs = ARENA_NEW(&multiblit_arena, struct g2d_surface_pair, layers);
+  if (!pairs) {
+    printf("Fail to allocate %d surface pairs from the frame arena\n", layers);
+    return;
   }
+  for (n = 0; n < layers; n++)
+    sp[n] = &pairs[n];
 
   sp[0]->d.planes[0] = g_buf_phys;
   sp[0]->d.left = 0;
@@ -248,34 +255,13 @@ static void draw_image_with_multiblit(void *handle,
     sp[i]->s.blendfunc = G2D_ONE;
     buf = img_info_ptr[i]->img_ptr;
 
-    switch (sp[i]->s.format) {
-    case G2D_RGB565:
-    case G2D_RGBA8888:
-    case G2D_RGBX8888:
-    case G2D_BGRA8888:
-    case G2D_BGRX8888:
-    case G2D_BGR565:
-    case G2D_YUYV:
-    case G2D_UYVY:
-      sp[i]->s.planes[0] = buf->buf_paddr;
-      sp[i]->s.global_alpha = 0x80;
-      break;
-    case G2D_NV16:
-      sp[i]->s.planes[0] = buf->buf_paddr;
-      sp[i]->s.planes[1] = buf->buf_paddr + sp[i]->s.width * sp[i]->s.height;
-      sp[i]->s.global_alpha = 0xff;
-      break;
-    case G2D_I420:
-      sp[i]->s.planes[0] = buf->buf_paddr;
-      sp[i]->s.planes[1] = buf->buf_paddr + sp[i]->s.width * sp[i]->s.height;
-      sp[i]->s.planes[2] =
-          sp[i]->s.planes[1] + sp[i]->s.width * sp[i]->s.height / 4;
-      sp[i]->s.global_alpha = 0x80;
-      break;
-    default:
+    if (format_layout(sp[i]->s.format, sp[i]->s.stride, sp[i]->s.height,
+                      FORMAT_PACKED, &layout)) {
       printf("Unsupport image format in the example code\n");
       return;
     }
+    format_set_planes(&sp[i]->s, buf, &layout);
+    sp[i]->s.global_alpha = sp[i]->s.format == G2D_NV16 ? 0xff : 0x80;
   }
 
   /* alpha blending*/
@@ -299,7 +285,12 @@ void Test_g2d_multi_blit(void *handle, struct g2d_buf *buf[],
   struct img_info *img_info_ptr[layers];
 
   for (i = 0; i < layers; i++) {
-    img_info_ptr[i] = (struct img_info *)malloc(sizeof(struct img_info));
+    img_info_ptr[i] = ARENA_NEW(&multiblit_arena, struct img_info, 1);
+    if (!img_info_ptr[i]) {
+      printf("Fail to allocate the image records from the frame arena\n");
+      arena_reset(&multiblit_arena);
+      return;
+    }
   }
 
   img_info_ptr[0]->img_left = 0;
@@ -391,6 +382,9 @@ void Test_g2d_multi_blit(void *handle, struct g2d_buf *buf[],
   img_info_ptr[7]->img_ptr = buf[3];
 
   draw_image_with_multiblit(handle, img_info_ptr, layers, screen_info);
+
+  /* g2d_finish has returned, nothing of this frame is read anymore */
+  arena_reset(&multiblit_arena);
 }
 
 void clear_screen_with_g2d(void *handle, screeninfo_t *screen_info,
@@ -436,31 +430,11 @@ int main(int argc, char **argv) {
 
   clear_screen_with_g2d(g2dHandle, &screen_info, 0xff000000);
   // TODO parse the para from filename or an xml which descript the blit.
-  g2dDataBuf[0] = createG2DTextureBuf("1024x768-rgb565.rgb");
-  if (!g2dDataBuf[0])
-    goto no_file;
-
-  g2dDataBuf[1] = createG2DTextureBuf("800x600-bgr565.rgb");
-  if (!g2dDataBuf[1])
-    goto no_file;
-
-  g2dDataBuf[2] = createG2DTextureBuf("480x360-bgr565.rgb");
-  if (!g2dDataBuf[2])
-    goto no_file;
-
-  g2dDataBuf[3] = createG2DTextureBuf("176x144-yuv420p.yuv");
-  if (!g2dDataBuf[3])
-    goto no_file;
-
-  g2dDataBuf[4] = createG2DTextureBuf("352x288-nv16.yuv");
-  if (!g2dDataBuf[4])
-    goto no_file;
-
-  g2dDataBuf[5] = createG2DTextureBuf("352x288-yuyv.yuv");
-  if (!g2dDataBuf[5])
+  if (load_assets(g2dDataBuf))
     goto no_file;
 
   src_file_available = 1;
+  cache_stats_report("texture load");
 
   gettimeofday(&tv1, NULL);
 
@@ -500,6 +474,7 @@ int main(int argc, char **argv) {
   printf(
       "Overlay rendering time %dus .\n",
       (int)((tv2.tv_sec - tv1.tv_sec) * 1000000 + tv2.tv_usec - tv1.tv_usec));
+  cache_stats_report("overlay frame");
 
   graphics_update(&screen_info);
 
@@ -542,6 +517,7 @@ int main(int argc, char **argv) {
   printf(
       "Overlay rendering with blur effect time %dus .\n",
       (int)((tv2.tv_sec - tv1.tv_sec) * 1000000 + tv2.tv_usec - tv1.tv_usec));
+  cache_stats_report("blur frame");
 
   graphics_update(&screen_info);
 
@@ -550,6 +526,9 @@ int main(int argc, char **argv) {
 
   g2d_query_feature(g2dHandle, G2D_MULTI_SOURCE_BLT, &g2d_feature_available);
   if (g2d_feature_available == 1) {
+    long long heap_allocs;
+
+    arena_init(&multiblit_arena, multiblit_mem, sizeof(multiblit_mem));
     gettimeofday(&tv1, NULL);
 
     Test_g2d_multi_blit(g2dHandle, g2dDataBuf, &screen_info);
@@ -558,6 +537,22 @@ int main(int argc, char **argv) {
     printf(
         "Overlay rendering with multiblit time %dus .\n",
         (int)((tv2.tv_sec - tv1.tv_sec) * 1000000 + tv2.tv_usec - tv1.tv_usec));
+    cache_stats_report("multiblit frame");
+
+    heap_allocs = alloc_stats_heap_allocs();
+    for (int i = 0; i < MULTIBLIT_FRAMES; i++)
+      Test_g2d_multi_blit(g2dHandle, g2dDataBuf, &screen_info);
+    heap_allocs = alloc_stats_heap_allocs() - heap_allocs;
+    if (!ALLOC_STATS_TRACKING) {
+      printf("multiblit steady state: heap allocations not counted, build "
+             "with -DG2D_ALLOC_STATS\n");
+    } else {
+      printf("multiblit steady state: %lld heap allocations in %d frames\n",
+             heap_allocs, MULTIBLIT_FRAMES);
+      if (heap_allocs)
+        retval = TFAIL;
+    }
+    arena_report(&multiblit_arena, "multiblit");
 
     graphics_update(&screen_info);
 
@@ -580,12 +575,8 @@ no_file:
     retval = -EINVAL;
   }
 
-  for (int i = 0; i < sizeof(g2dDataBuf) / sizeof(g2dDataBuf[0]); i++) {
-    if (g2dDataBuf[i]) {
-      releaseG2DTextureBuf(g2dDataBuf[i]);
-      g2dDataBuf[i] = NULL;
-    }
-  }
+  /* the assets are views of the slab */
+  slab_free(&asset_slab);
 
   if (!g2dHandle)
     g2d_close(g2dHandle);
@@ -0,0 +1,660 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_prof.c
+ *
+ * LD_PRELOAD interposer for libg2d. Every g2d entry point is forwarded to the
+ * real library and its call count, latency histogram, pixels and bytes per
+ * call are accumulated. A table is printed to stderr at exit, and written as
+ * json too when G2D_PROF_JSON=<path> is set. With G2D_STATS_SHM=1 the
+ * counters live in shared memory where g2d_top can watch them, see
+ * g2d_stats.h.
+ *
+ *   LD_PRELOAD=/opt/g2d_samples/libg2d_prof.so ./g2d_basic_test
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "g2d.h"
+#include "g2dExt.h"
+#include "g2d_bench.h"
+#include "g2d_stats.h"
+
+#define PROF_JSON_ENV "G2D_PROF_JSON"
+
+enum prof_func {
+  PROF_OPEN,
+  PROF_CLOSE,
+  PROF_MAKE_CURRENT,
+  PROF_CLEAR,
+  PROF_BLIT,
+  PROF_BLITEX,
+  PROF_COPY,
+  PROF_MULTI_BLIT,
+  PROF_QUERY_HARDWARE,
+  PROF_QUERY_FEATURE,
+  PROF_QUERY_CAP,
+  PROF_ENABLE,
+  PROF_DISABLE,
+  PROF_CACHE_OP,
+  PROF_ALLOC,
+  PROF_BUF_FROM_FD,
+  PROF_BUF_EXPORT_FD,
+  PROF_BUF_FROM_VIRT_ADDR,
+  PROF_FREE,
+  PROF_FLUSH,
+  PROF_FINISH,
+  PROF_SET_WARP_COORDINATES,
+  PROF_FUNC_COUNT,
+};
+
+static const char *func_names[PROF_FUNC_COUNT] = {
+    [PROF_OPEN] = "g2d_open",
+    [PROF_CLOSE] = "g2d_close",
+    [PROF_MAKE_CURRENT] = "g2d_make_current",
+    [PROF_CLEAR] = "g2d_clear",
+    [PROF_BLIT] = "g2d_blit",
+    [PROF_BLITEX] = "g2d_blitEx",
+    [PROF_COPY] = "g2d_copy",
+    [PROF_MULTI_BLIT] = "g2d_multi_blit",
+    [PROF_QUERY_HARDWARE] = "g2d_query_hardware",
+    [PROF_QUERY_FEATURE] = "g2d_query_feature",
+    [PROF_QUERY_CAP] = "g2d_query_cap",
+    [PROF_ENABLE] = "g2d_enable",
+    [PROF_DISABLE] = "g2d_disable",
+    [PROF_CACHE_OP] = "g2d_cache_op",
+    [PROF_ALLOC] = "g2d_alloc",
+    [PROF_BUF_FROM_FD] = "g2d_buf_from_fd",
+    [PROF_BUF_EXPORT_FD] = "g2d_buf_export_fd",
+    [PROF_BUF_FROM_VIRT_ADDR] = "g2d_buf_from_virt_addr",
+    [PROF_FREE] = "g2d_free",
+    [PROF_FLUSH] = "g2d_flush",
+    [PROF_FINISH] = "g2d_finish",
+    [PROF_SET_WARP_COORDINATES] = "g2d_set_warp_coordinates",
+};
+
+/* private counters, replaced by the shared memory block when enabled */
+static struct stats_block local_stats;
+static struct stats_block *stats = &local_stats;
+static char stats_shm_name[64];
+
+/* completion time of the last g2d_finish, the frames are measured from it */
+static unsigned long long last_finish_ns;
+
+/* blending doubles the destination traffic, follow g2d_enable(G2D_BLEND) */
+static int prof_blend;
+
+static unsigned long long prof_now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *prof_resolve(const char *name) {
+  void *sym = dlsym(RTLD_NEXT, name);
+
+  if (!sym) {
+    fprintf(stderr, "g2d_prof: %s not found in libg2d\n", name);
+    exit(1);
+  }
+  return sym;
+}
+
+static int prof_bucket(unsigned long long ns) {
+  unsigned long long us = ns / 1000;
+  int b = 0;
+
+  while (us && b < STATS_BUCKETS - 1) {
+    us >>= 1;
+    b++;
+  }
+  return b;
+}
+
+static void prof_count(struct stats_counter *e, unsigned long long ns,
+                       long long pixels, long long bytes) {
+  unsigned long long old;
+
+  __atomic_fetch_add(&e->calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&e->total_ns, ns, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&e->pixels, pixels, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&e->bytes, bytes, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&e->hist[prof_bucket(ns)], 1, __ATOMIC_RELAXED);
+
+  old = __atomic_load_n(&e->max_ns, __ATOMIC_RELAXED);
+  while (ns > old && !__atomic_compare_exchange_n(&e->max_ns, &old, ns, 1,
+                                                  __ATOMIC_RELAXED,
+                                                  __ATOMIC_RELAXED))
+    ;
+  old = __atomic_load_n(&e->min_ns, __ATOMIC_RELAXED);
+  while ((!old || ns < old) &&
+         !__atomic_compare_exchange_n(&e->min_ns, &old, ns, 1,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+static void prof_record(enum prof_func func, unsigned long long start,
+                        long long pixels, long long bytes) {
+  prof_count(&stats->funcs[func], prof_now_ns() - start, pixels, bytes);
+}
+
+/* Interval between two g2d_finish completions, counted as one frame. */
+static void prof_frame(void) {
+  unsigned long long now = prof_now_ns();
+  unsigned long long prev =
+      __atomic_exchange_n(&last_finish_ns, now, __ATOMIC_RELAXED);
+
+  if (prev && now > prev)
+    prof_count(&stats->frames, now - prev, 0, 0);
+}
+
+static long long prof_pixels(const struct g2d_surface *s) {
+  return (long long)(s->right - s->left) * (s->bottom - s->top);
+}
+
+/* Upper bound in us of the bucket holding the pct percentile. */
+static unsigned long long prof_percentile(const struct stats_counter *e,
+                                          int pct) {
+  unsigned long long seen = 0, rank = (e->calls * pct + 99) / 100;
+  int b;
+
+  for (b = 0; b < STATS_BUCKETS - 1; b++) {
+    seen += e->hist[b];
+    if (seen >= rank)
+      break;
+  }
+  return 1ULL << b;
+}
+
+static void prof_report_text(void) {
+  unsigned long long calls = 0, total_ns = 0;
+  int i, b;
+
+  for (i = 0; i < PROF_FUNC_COUNT; i++) {
+    calls += stats->funcs[i].calls;
+    total_ns += stats->funcs[i].total_ns;
+  }
+
+  fprintf(stderr, "\n---------------- g2d_prof: %llu calls, %.1fms in g2d "
+                  "----------------\n",
+          calls, total_ns / 1e6);
+  fprintf(stderr, "%-26s %8s %10s %9s %9s %9s %8s %8s %10s %10s\n", "function",
+          "calls", "total ms", "avg us", "min us", "max us", "p50 <us",
+          "p99 <us", "pixel/call", "byte/call");
+
+  for (i = 0; i < PROF_FUNC_COUNT; i++) {
+    const struct stats_counter *e = &stats->funcs[i];
+
+    if (!e->calls)
+      continue;
+
+    fprintf(stderr,
+            "%-26s %8llu %10.2f %9.1f %9.1f %9.1f %8llu %8llu %10llu %10llu\n",
+            e->name, e->calls, e->total_ns / 1e6,
+            e->total_ns / 1e3 / e->calls, e->min_ns / 1e3, e->max_ns / 1e3,
+            prof_percentile(e, 50), prof_percentile(e, 99),
+            e->pixels / e->calls, e->bytes / e->calls);
+  }
+
+  if (stats->frames.calls) {
+    const struct stats_counter *e = &stats->frames;
+
+    fprintf(stderr,
+            "%-26s %8llu %10.2f %9.1f %9.1f %9.1f %8llu %8llu\n", e->name,
+            e->calls, e->total_ns / 1e6, e->total_ns / 1e3 / e->calls,
+            e->min_ns / 1e3, e->max_ns / 1e3, prof_percentile(e, 50),
+            prof_percentile(e, 99));
+  }
+
+  fprintf(stderr, "\nlatency histograms (upper bound us:calls)\n");
+  for (i = 0; i < PROF_FUNC_COUNT; i++) {
+    const struct stats_counter *e = &stats->funcs[i];
+
+    if (!e->calls)
+      continue;
+
+    fprintf(stderr, "%-26s", e->name);
+    for (b = 0; b < STATS_BUCKETS; b++) {
+      if (!e->hist[b])
+        continue;
+      if (b == STATS_BUCKETS - 1)
+        fprintf(stderr, " inf:%llu", e->hist[b]);
+      else
+        fprintf(stderr, " %llu:%llu", 1ULL << b, e->hist[b]);
+    }
+    fprintf(stderr, "\n");
+  }
+}
+
+static void prof_report_json(const char *path) {
+  FILE *fp = fopen(path, "w");
+  int i, b, first = 1;
+
+  if (!fp) {
+    fprintf(stderr, "g2d_prof: FAILED to open %s\n", path);
+    return;
+  }
+
+  fprintf(fp, "{\"functions\":[");
+  for (i = 0; i < PROF_FUNC_COUNT; i++) {
+    const struct stats_counter *e = &stats->funcs[i];
+
+    if (!e->calls)
+      continue;
+
+    fprintf(fp,
+            "%s\n {\"name\":\"%s\",\"calls\":%llu,\"total_us\":%.3f,"
+            "\"min_us\":%.3f,\"max_us\":%.3f,\"pixels\":%llu,\"bytes\":%llu,"
+            "\"histogram_us\":[",
+            first ? "" : ",", e->name, e->calls, e->total_ns / 1e3,
+            e->min_ns / 1e3, e->max_ns / 1e3, e->pixels, e->bytes);
+    for (b = 0; b < STATS_BUCKETS; b++)
+      fprintf(fp, "%s%llu", b ? "," : "", e->hist[b]);
+    fprintf(fp, "]}");
+    first = 0;
+  }
+  fprintf(fp, "\n],\"frames\":{\"count\":%llu,\"total_us\":%.3f,"
+              "\"min_us\":%.3f,\"max_us\":%.3f,\"histogram_us\":[",
+          stats->frames.calls, stats->frames.total_ns / 1e3,
+          stats->frames.min_ns / 1e3, stats->frames.max_ns / 1e3);
+  for (b = 0; b < STATS_BUCKETS; b++)
+    fprintf(fp, "%s%llu", b ? "," : "", stats->frames.hist[b]);
+  fprintf(fp, "]}");
+  fprintf(fp, ",\"histogram_bounds_us\":\"bucket b counts calls below "
+              "2^b us, the last one is open\"}\n");
+  fclose(fp);
+}
+
+/*
+ * Move the counters to a shared memory object when G2D_STATS_SHM is set. The
+ * value is the object name if it starts with '/', otherwise the default
+ * STATS_SHM_PREFIX<pid> is used. On failure the private counters are kept.
+ */
+static void prof_open_shm(void) {
+  const char *env = getenv(STATS_SHM_ENV);
+  struct stats_block *shm;
+  int fd;
+
+  if (!env || !*env)
+    return;
+
+  if (env[0] == '/')
+    snprintf(stats_shm_name, sizeof(stats_shm_name), "%s", env);
+  else
+    snprintf(stats_shm_name, sizeof(stats_shm_name), "%s%d",
+             STATS_SHM_PREFIX, (int)getpid());
+
+  fd = shm_open(stats_shm_name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0 || ftruncate(fd, sizeof(*shm)) < 0) {
+    fprintf(stderr, "g2d_prof: FAILED to create %s\n", stats_shm_name);
+    if (fd >= 0)
+      close(fd);
+    stats_shm_name[0] = 0;
+    return;
+  }
+  shm = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (shm == MAP_FAILED) {
+    fprintf(stderr, "g2d_prof: FAILED to map %s\n", stats_shm_name);
+    shm_unlink(stats_shm_name);
+    stats_shm_name[0] = 0;
+    return;
+  }
+
+  memcpy(shm, &local_stats, sizeof(*shm));
+  shm->magic = 0;
+  stats = shm;
+  /* readers check the magic, publish it once the header is complete */
+  __atomic_store_n(&shm->magic, STATS_MAGIC, __ATOMIC_RELEASE);
+}
+
+__attribute__((constructor)) static void prof_init(void) {
+  int i;
+
+  local_stats.version = STATS_VERSION;
+  local_stats.pid = getpid();
+  local_stats.func_count = PROF_FUNC_COUNT;
+  local_stats.start_ns = prof_now_ns();
+  snprintf(local_stats.process, sizeof(local_stats.process), "%s",
+           program_invocation_short_name);
+  for (i = 0; i < PROF_FUNC_COUNT; i++)
+    snprintf(local_stats.funcs[i].name, STATS_NAME_LEN, "%s", func_names[i]);
+  snprintf(local_stats.frames.name, STATS_NAME_LEN, "frames (finish to finish)");
+  local_stats.magic = STATS_MAGIC;
+
+  prof_open_shm();
+}
+
+__attribute__((destructor)) static void prof_exit(void) {
+  const char *json = getenv(PROF_JSON_ENV);
+
+  prof_report_text();
+  if (json && *json)
+    prof_report_json(json);
+
+  if (stats_shm_name[0])
+    shm_unlink(stats_shm_name);
+}
+
+int g2d_open(void **handle) {
+  static int (*real)(void **);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_open");
+  t = prof_now_ns();
+  ret = real(handle);
+  prof_record(PROF_OPEN, t, 0, 0);
+  return ret;
+}
+
+int g2d_close(void *handle) {
+  static int (*real)(void *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_close");
+  t = prof_now_ns();
+  ret = real(handle);
+  prof_record(PROF_CLOSE, t, 0, 0);
+  return ret;
+}
+
+int g2d_make_current(void *handle, enum g2d_hardware_type type) {
+  static int (*real)(void *, enum g2d_hardware_type);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_make_current");
+  t = prof_now_ns();
+  ret = real(handle, type);
+  prof_record(PROF_MAKE_CURRENT, t, 0, 0);
+  return ret;
+}
+
+int g2d_clear(void *handle, struct g2d_surface *area) {
+  static int (*real)(void *, struct g2d_surface *);
+  struct bench_bytes bytes;
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_clear");
+  t = prof_now_ns();
+  ret = real(handle, area);
+  bench_clear_bytes(area, &bytes);
+  prof_record(PROF_CLEAR, t, prof_pixels(area), bytes.read + bytes.written);
+  return ret;
+}
+
+int g2d_blit(void *handle, struct g2d_surface *src, struct g2d_surface *dst) {
+  static int (*real)(void *, struct g2d_surface *, struct g2d_surface *);
+  struct bench_bytes bytes;
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_blit");
+  t = prof_now_ns();
+  ret = real(handle, src, dst);
+  bench_blit_bytes(src, dst, prof_blend, &bytes);
+  prof_record(PROF_BLIT, t, prof_pixels(dst), bytes.read + bytes.written);
+  return ret;
+}
+
+int g2d_blitEx(void *handle, struct g2d_surfaceEx *srcEx,
+               struct g2d_surfaceEx *dstEx) {
+  static int (*real)(void *, struct g2d_surfaceEx *, struct g2d_surfaceEx *);
+  struct bench_bytes bytes;
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_blitEx");
+  t = prof_now_ns();
+  ret = real(handle, srcEx, dstEx);
+  bench_blit_bytes(&srcEx->base, &dstEx->base, prof_blend, &bytes);
+  prof_record(PROF_BLITEX, t, prof_pixels(&dstEx->base),
+              bytes.read + bytes.written);
+  return ret;
+}
+
+int g2d_copy(void *handle, struct g2d_buf *d, struct g2d_buf *s, int size) {
+  static int (*real)(void *, struct g2d_buf *, struct g2d_buf *, int);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_copy");
+  t = prof_now_ns();
+  ret = real(handle, d, s, size);
+  prof_record(PROF_COPY, t, 0, 2LL * size);
+  return ret;
+}
+
+int g2d_multi_blit(void *handle, struct g2d_surface_pair *sp[], int layers) {
+  static int (*real)(void *, struct g2d_surface_pair *[], int);
+  struct bench_bytes bytes;
+  long long pixels = 0, moved = 0;
+  unsigned long long t;
+  int i, ret;
+
+  if (!real)
+    real = prof_resolve("g2d_multi_blit");
+  t = prof_now_ns();
+  ret = real(handle, sp, layers);
+  for (i = 0; i < layers; i++) {
+    bench_blit_bytes(&sp[i]->s, &sp[i]->d, prof_blend, &bytes);
+    pixels += prof_pixels(&sp[i]->d);
+    moved += bytes.read + bytes.written;
+  }
+  prof_record(PROF_MULTI_BLIT, t, pixels, moved);
+  return ret;
+}
+
+int g2d_query_hardware(void *handle, enum g2d_hardware_type type,
+                       int *available) {
+  static int (*real)(void *, enum g2d_hardware_type, int *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_query_hardware");
+  t = prof_now_ns();
+  ret = real(handle, type, available);
+  prof_record(PROF_QUERY_HARDWARE, t, 0, 0);
+  return ret;
+}
+
+int g2d_query_feature(void *handle, enum g2d_feature feature, int *available) {
+  static int (*real)(void *, enum g2d_feature, int *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_query_feature");
+  t = prof_now_ns();
+  ret = real(handle, feature, available);
+  prof_record(PROF_QUERY_FEATURE, t, 0, 0);
+  return ret;
+}
+
+int g2d_query_cap(void *handle, enum g2d_cap_mode cap, int *enable) {
+  static int (*real)(void *, enum g2d_cap_mode, int *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_query_cap");
+  t = prof_now_ns();
+  ret = real(handle, cap, enable);
+  prof_record(PROF_QUERY_CAP, t, 0, 0);
+  return ret;
+}
+
+int g2d_enable(void *handle, enum g2d_cap_mode cap) {
+  static int (*real)(void *, enum g2d_cap_mode);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_enable");
+  t = prof_now_ns();
+  ret = real(handle, cap);
+  prof_record(PROF_ENABLE, t, 0, 0);
+  if (cap == G2D_BLEND && !ret)
+    prof_blend = 1;
+  return ret;
+}
+
+int g2d_disable(void *handle, enum g2d_cap_mode cap) {
+  static int (*real)(void *, enum g2d_cap_mode);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_disable");
+  t = prof_now_ns();
+  ret = real(handle, cap);
+  prof_record(PROF_DISABLE, t, 0, 0);
+  if (cap == G2D_BLEND && !ret)
+    prof_blend = 0;
+  return ret;
+}
+
+int g2d_cache_op(struct g2d_buf *buf, enum g2d_cache_mode op) {
+  static int (*real)(struct g2d_buf *, enum g2d_cache_mode);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_cache_op");
+  t = prof_now_ns();
+  ret = real(buf, op);
+  prof_record(PROF_CACHE_OP, t, 0, buf ? buf->buf_size : 0);
+  return ret;
+}
+
+struct g2d_buf *g2d_alloc(int size, int cacheable) {
+  static struct g2d_buf *(*real)(int, int);
+  struct g2d_buf *buf;
+  unsigned long long t;
+
+  if (!real)
+    real = prof_resolve("g2d_alloc");
+  t = prof_now_ns();
+  buf = real(size, cacheable);
+  prof_record(PROF_ALLOC, t, 0, buf ? size : 0);
+  return buf;
+}
+
+struct g2d_buf *g2d_buf_from_fd(int fd) {
+  static struct g2d_buf *(*real)(int);
+  struct g2d_buf *buf;
+  unsigned long long t;
+
+  if (!real)
+    real = prof_resolve("g2d_buf_from_fd");
+  t = prof_now_ns();
+  buf = real(fd);
+  prof_record(PROF_BUF_FROM_FD, t, 0, buf ? buf->buf_size : 0);
+  return buf;
+}
+
+int g2d_buf_export_fd(struct g2d_buf *buf) {
+  static int (*real)(struct g2d_buf *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_buf_export_fd");
+  t = prof_now_ns();
+  ret = real(buf);
+  prof_record(PROF_BUF_EXPORT_FD, t, 0, 0);
+  return ret;
+}
+
+struct g2d_buf *g2d_buf_from_virt_addr(void *vaddr, int size) {
+  static struct g2d_buf *(*real)(void *, int);
+  struct g2d_buf *buf;
+  unsigned long long t;
+
+  if (!real)
+    real = prof_resolve("g2d_buf_from_virt_addr");
+  t = prof_now_ns();
+  buf = real(vaddr, size);
+  prof_record(PROF_BUF_FROM_VIRT_ADDR, t, 0, buf ? size : 0);
+  return buf;
+}
+
+int g2d_free(struct g2d_buf *buf) {
+  static int (*real)(struct g2d_buf *);
+  unsigned long long t;
+  int size = buf ? buf->buf_size : 0;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_free");
+  t = prof_now_ns();
+  ret = real(buf);
+  prof_record(PROF_FREE, t, 0, size);
+  return ret;
+}
+
+int g2d_flush(void *handle) {
+  static int (*real)(void *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_flush");
+  t = prof_now_ns();
+  ret = real(handle);
+  prof_record(PROF_FLUSH, t, 0, 0);
+  return ret;
+}
+
+int g2d_finish(void *handle) {
+  static int (*real)(void *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_finish");
+  t = prof_now_ns();
+  ret = real(handle);
+  prof_record(PROF_FINISH, t, 0, 0);
+  prof_frame();
+  return ret;
+}
+
+int g2d_set_warp_coordinates(void *handle, struct g2d_warp_coordinates *info) {
+  static int (*real)(void *, struct g2d_warp_coordinates *);
+  unsigned long long t;
+  int ret;
+
+  if (!real)
+    real = prof_resolve("g2d_set_warp_coordinates");
+  t = prof_now_ns();
+  ret = real(handle, info);
+  prof_record(PROF_SET_WARP_COORDINATES, t, 0, 0);
+  return ret;
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_queue_depth.c
+ *
+ * Sweeps the number of operations submitted between two g2d_finish calls
+ * (1, 2, 4, ... max depth) for each operation type, and reports throughput
+ * and batch latency against the depth.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g2d.h"
+#include "g2d_bench.h"
+
+#define TEST_WIDTH 1920
+#define TEST_HEIGHT 1080
+#define MAX_DEPTH 256
+#define TEST_OPS 512
+#define BAR_WIDTH 32
+
+enum op_type {
+  OP_BLIT,
+  OP_CLEAR,
+  OP_ROTATE,
+  OP_RESIZE,
+  OP_CSC,
+  OP_BLEND,
+  OP_COUNT,
+};
+
+static const char *op_names[OP_COUNT] = {
+    [OP_BLIT] = "blit",     [OP_CLEAR] = "clear", [OP_ROTATE] = "rot90",
+    [OP_RESIZE] = "resize", [OP_CSC] = "csc",     [OP_BLEND] = "blend",
+};
+
+struct depth_result {
+  int depth;
+  int ops;
+  long long total_us;
+  struct bench_stats batch;
+};
+
+static const struct option longOptions[] = {
+    {"help", no_argument, NULL, 'h'},
+    {"source", required_argument, NULL, 's'},
+    {"ops", required_argument, NULL, 'n'},
+    {"depth", required_argument, NULL, 'd'},
+    {"output", required_argument, NULL, 'o'},
+    {NULL, 0, NULL, 0}};
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -s, --source WIDTHxHEIGHT  surface size (default %dx%d)\n"
+          "  -n, --ops N                operations per depth (default %d)\n"
+          "  -d, --depth N              largest depth of the sweep (default "
+          "%d)\n"
+          "  -o, --output FILE          also write the results as csv\n"
+          "  -h, --help                 show this message\n",
+          name, TEST_WIDTH, TEST_HEIGHT, TEST_OPS, MAX_DEPTH);
+}
+
+static void set_surface(struct g2d_surface *s, struct g2d_buf *buf, int width,
+                        int height, enum g2d_format format) {
+  memset(s, 0, sizeof(*s));
+  s->format = format;
+  s->planes[0] = buf->buf_paddr;
+  s->planes[1] = buf->buf_paddr + width * height;
+  s->planes[2] = buf->buf_paddr + width * height * 2;
+  s->left = 0;
+  s->top = 0;
+  s->right = width;
+  s->bottom = height;
+  s->stride = width;
+  s->width = width;
+  s->height = height;
+  s->rot = G2D_ROTATION_0;
+}
+
+/*
+ * Sets up src/dst for the given operation.
+ * Returns the number of destination pixels written by one operation.
+ */
+static int setup_op(enum op_type op, struct g2d_buf *s_buf,
+                    struct g2d_buf *d_buf, int width, int height,
+                    struct g2d_surface *src, struct g2d_surface *dst) {
+  set_surface(src, s_buf, width, height, G2D_RGBA8888);
+  set_surface(dst, d_buf, width, height, G2D_RGBA8888);
+
+  switch (op) {
+  case OP_CLEAR:
+    dst->clrcolor = 0xffeeddcc;
+    break;
+  case OP_ROTATE:
+    set_surface(dst, d_buf, height, width, G2D_RGBA8888);
+    dst->rot = G2D_ROTATION_90;
+    break;
+  case OP_RESIZE:
+    set_surface(src, s_buf, width >> 1, height >> 1, G2D_RGBA8888);
+    break;
+  case OP_CSC:
+    src->format = G2D_YUYV;
+    break;
+  case OP_BLEND:
+    src->blendfunc = G2D_ONE;
+    dst->blendfunc = G2D_ONE_MINUS_SRC_ALPHA;
+    src->global_alpha = 0x80;
+    dst->global_alpha = 0xff;
+    break;
+  default:
+    break;
+  }
+
+  return dst->width * dst->height;
+}
+
+static void submit_op(void *handle, enum op_type op, struct g2d_surface *src,
+                      struct g2d_surface *dst) {
+  if (op == OP_CLEAR)
+    g2d_clear(handle, dst);
+  else
+    g2d_blit(handle, src, dst);
+}
+
+/* Runs ops operations, calling g2d_finish after every depth of them. */
+static int run_depth(void *handle, enum op_type op, struct g2d_surface *src,
+                     struct g2d_surface *dst, int depth, int ops,
+                     double *samples, struct depth_result *res) {
+  int batches = ops / depth;
+  long long t1, t2, start;
+  int b, i;
+
+  if (op == OP_BLEND) {
+    g2d_enable(handle, G2D_BLEND);
+    g2d_enable(handle, G2D_GLOBAL_ALPHA);
+  }
+
+  /* warm up so the first batch does not pay for lazy initialisation */
+  for (i = 0; i < depth; i++)
+    submit_op(handle, op, src, dst);
+  g2d_finish(handle);
+
+  start = bench_get_time_us();
+  for (b = 0; b < batches; b++) {
+    t1 = bench_get_time_us();
+    for (i = 0; i < depth; i++)
+      submit_op(handle, op, src, dst);
+    g2d_finish(handle);
+    t2 = bench_get_time_us();
+    samples[b] = (double)(t2 - t1);
+  }
+
+  res->total_us = bench_get_time_us() - start;
+
+  if (op == OP_BLEND) {
+    g2d_disable(handle, G2D_GLOBAL_ALPHA);
+    g2d_disable(handle, G2D_BLEND);
+  }
+
+  res->depth = depth;
+  res->ops = batches * depth;
+  bench_compute_stats(samples, batches, &res->batch);
+
+  return 0;
+}
+
+static void print_results(FILE *csv, enum op_type op, int pixels,
+                          struct depth_result *res, int count) {
+  double best = 0, rate;
+  int i, n, bar;
+
+  for (i = 0; i < count; i++) {
+    rate = res[i].total_us ? res[i].ops * 1e6 / res[i].total_us : 0;
+    if (rate > best)
+      best = rate;
+  }
+
+  printf("\n---------------- %s: throughput / latency vs depth "
+         "----------------\n",
+         op_names[op]);
+  printf("%6s %10s %10s %12s %12s %10s\n", "depth", "ops/s", "Mpixel/s",
+         "batch med us", "batch p99 us", "us/op");
+
+  for (i = 0; i < count; i++) {
+    rate = res[i].total_us ? res[i].ops * 1e6 / res[i].total_us : 0;
+    bar = best > 0 ? (int)(rate * BAR_WIDTH / best + 0.5) : 0;
+
+    printf("%6d %10.1f %10.1f %12.1f %12.1f %10.1f ", res[i].depth, rate,
+           rate * pixels / 1e6, res[i].batch.median, res[i].batch.p99,
+           res[i].batch.median / res[i].depth);
+    for (n = 0; n < bar; n++)
+      putchar('#');
+    putchar('\n');
+
+    if (csv)
+      fprintf(csv, "%s,%d,%d,%lld,%.1f,%.1f,%.1f,%.1f,%.2f\n", op_names[op],
+              res[i].depth, res[i].ops, res[i].total_us, rate,
+              rate * pixels / 1e6, res[i].batch.median, res[i].batch.p99,
+              res[i].batch.median / res[i].depth);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int test_width = TEST_WIDTH, test_height = TEST_HEIGHT;
+  int test_ops = TEST_OPS, max_depth = MAX_DEPTH;
+  struct depth_result res[32];
+  struct g2d_surface src, dst;
+  struct g2d_buf *s_buf, *d_buf;
+  char *csv_file = NULL;
+  FILE *csv = NULL;
+  double *samples;
+  void *handle = NULL;
+  int available = 0;
+  int depth, count, pixels;
+  int op, ret = 0;
+
+  while (1) {
+    int optionIndex;
+    int ic = getopt_long(argc, argv, "hs:n:d:o:", longOptions, &optionIndex);
+    if (ic == -1)
+      break;
+
+    switch (ic) {
+    case 'h':
+      usage(argv[0]);
+      return 0;
+    case 's':
+      if (2 != sscanf(optarg, "%dx%d", &test_width, &test_height) ||
+          test_width <= 0 || test_height <= 0) {
+        fprintf(stderr, "Invalid size '%s', must be \"w x h\"\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 'n':
+      if (1 != sscanf(optarg, "%d", &test_ops) || test_ops < 1) {
+        fprintf(stderr, "Invalid ops '%s'\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 'd':
+      if (1 != sscanf(optarg, "%d", &max_depth) || max_depth < 1) {
+        fprintf(stderr, "Invalid depth '%s'\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 'o':
+      csv_file = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return -EINVAL;
+    }
+  }
+
+  test_width = (test_width + 15) & ~15;
+  test_height = (test_height + 15) & ~15;
+
+  /* every depth runs at least one full batch */
+  if (test_ops < max_depth)
+    test_ops = max_depth;
+
+  printf("Width %d, Height %d, %d ops per depth, depth 1..%d\n", test_width,
+         test_height, test_ops, max_depth);
+
+  if (g2d_open(&handle)) {
+    printf("g2d_open fail.\n");
+    return -ENOTTY;
+  }
+
+  s_buf = g2d_alloc(test_width * test_height * 4, 0);
+  d_buf = g2d_alloc(test_width * test_height * 4, 0);
+  samples = malloc(sizeof(double) * test_ops);
+  if (!s_buf || !d_buf || !samples) {
+    printf("Fail to allocate test buffers\n");
+    ret = -ENOMEM;
+    goto err;
+  }
+
+  memset(s_buf->buf_vaddr, 0x80, test_width * test_height * 4);
+
+  if (csv_file) {
+    csv = fopen(csv_file, "w");
+    if (!csv) {
+      printf("FAILED to open csv file %s\n", csv_file);
+      ret = -EIO;
+      goto err;
+    }
+    fprintf(csv, "op,depth,ops,total_us,ops_per_s,mpixel_per_s,"
+                 "batch_median_us,batch_p99_us,us_per_op\n");
+  }
+
+  for (op = 0; op < OP_COUNT; op++) {
+    if (op == OP_CSC) {
+      g2d_query_feature(handle, G2D_SRC_YUV, &available);
+      if (!available) {
+        printf("\n%s: G2D_SRC_YUV not supported, skipped\n", op_names[op]);
+        continue;
+      }
+    }
+
+    pixels = setup_op(op, s_buf, d_buf, test_width, test_height, &src, &dst);
+
+    count = 0;
+    for (depth = 1; depth <= max_depth && count < 32; depth <<= 1)
+      run_depth(handle, op, &src, &dst, depth, test_ops, samples,
+                &res[count++]);
+
+    print_results(csv, op, pixels, res, count);
+  }
+
+err:
+  if (csv)
+    fclose(csv);
+  free(samples);
+  if (s_buf)
+    g2d_free(s_buf);
+  if (d_buf)
+    g2d_free(d_buf);
+  g2d_close(handle);
+
+  return ret;
+}
@@ -0,0 +1,864 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_record.c
+ *
+ * LD_PRELOAD interposer recording every g2d call of an application, with
+ * its full arguments, into the compact binary format of g2d_record.h, for
+ * g2d_replay. Set G2D_RECORD_FILE=<path> to record, and
+ * G2D_RECORD_SNAPSHOT=1 to also save the content of each buffer the first
+ * time an operation uses it.
+ *
+ * Records are packed into one of two fixed size buffers under a mutex; a
+ * writer thread streams the full one to the file while the other fills up,
+ * so the application only waits for the disk when both are full.
+ */
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "g2d.h"
+#include "g2dExt.h"
+#include "g2d_record.h"
+
+#define RECORD_FILE_ENV "G2D_RECORD_FILE"
+#define RECORD_SNAPSHOT_ENV "G2D_RECORD_SNAPSHOT"
+
+#define RECORD_BUFFER_SIZE (512 * 1024)
+
+struct rec_buffer {
+  struct g2d_buf *buf;
+  uint32_t id;
+  int snapshot_done;
+};
+
+static int rec_fd = -1;
+static int rec_snapshots;
+static uint64_t rec_start_ns;
+
+static pthread_mutex_t rec_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rec_full = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t rec_free = PTHREAD_COND_INITIALIZER;
+static pthread_t rec_writer;
+static char rec_data[2][RECORD_BUFFER_SIZE];
+static int rec_active;
+static size_t rec_fill;
+static int rec_pending = -1; /* buffer handed to the writer, -1 if none */
+static size_t rec_pending_len;
+static int rec_stop;
+
+/* buffers alive in the application, protected by rec_lock */
+static struct rec_buffer *rec_buffers;
+static int rec_buffer_count;
+static int rec_buffer_max;
+static uint32_t rec_next_id = 1;
+
+static unsigned long long rec_calls;
+static unsigned long long rec_bytes;
+static unsigned long long rec_g2d_ns;
+static unsigned long long rec_self_ns;
+
+static __thread uint32_t rec_tid;
+
+static uint64_t rec_now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void *rec_resolve(const char *name) {
+  void *sym = dlsym(RTLD_NEXT, name);
+
+  if (!sym) {
+    fprintf(stderr, "g2d_record: %s not found in libg2d\n", name);
+    exit(1);
+  }
+  return sym;
+}
+
+static void rec_write_all(const char *data, size_t len) {
+  ssize_t n;
+
+  while (len) {
+    n = write(rec_fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      fprintf(stderr, "g2d_record: write failed: %s\n", strerror(errno));
+      return;
+    }
+    data += n;
+    len -= n;
+  }
+}
+
+static void *rec_writer_main(void *arg) {
+  int idx;
+  size_t len;
+
+  (void)arg;
+  pthread_mutex_lock(&rec_lock);
+  while (1) {
+    while (rec_pending < 0 && !rec_stop)
+      pthread_cond_wait(&rec_full, &rec_lock);
+    if (rec_pending < 0)
+      break;
+
+    idx = rec_pending;
+    len = rec_pending_len;
+    pthread_mutex_unlock(&rec_lock);
+
+    rec_write_all(rec_data[idx], len);
+
+    pthread_mutex_lock(&rec_lock);
+    rec_pending = -1;
+    pthread_cond_broadcast(&rec_free);
+  }
+  pthread_mutex_unlock(&rec_lock);
+
+  return NULL;
+}
+
+/* Hands the active buffer to the writer. Called with rec_lock held. */
+static void rec_swap(void) {
+  while (rec_pending >= 0)
+    pthread_cond_wait(&rec_free, &rec_lock);
+
+  rec_pending = rec_active;
+  rec_pending_len = rec_fill;
+  rec_active ^= 1;
+  rec_fill = 0;
+  pthread_cond_signal(&rec_full);
+}
+
+/* Appends len bytes to the stream. Called with rec_lock held. */
+static void rec_put(const void *data, size_t len) {
+  const char *p = data;
+  size_t n;
+
+  rec_bytes += len;
+  while (len) {
+    if (rec_fill == RECORD_BUFFER_SIZE)
+      rec_swap();
+
+    n = RECORD_BUFFER_SIZE - rec_fill;
+    if (n > len)
+      n = len;
+    memcpy(rec_data[rec_active] + rec_fill, p, n);
+    rec_fill += n;
+    p += n;
+    len -= n;
+  }
+}
+
+static void rec_put_header(enum record_op op, void *handle, uint64_t start,
+                           uint64_t end, int ret, uint32_t size) {
+  struct record_header h;
+
+  h.op = op;
+  h.size = size;
+  h.handle = (uint64_t)(uintptr_t)handle;
+  h.start_ns = start - rec_start_ns;
+  h.duration_ns = end - start;
+  if (!rec_tid)
+    rec_tid = syscall(SYS_gettid);
+  h.tid = rec_tid;
+  h.ret = ret;
+  rec_put(&h, sizeof(h));
+}
+
+/* Buffer lookups, called with rec_lock held. */
+static struct rec_buffer *rec_find_buf(const struct g2d_buf *buf) {
+  int i;
+
+  for (i = 0; i < rec_buffer_count; i++)
+    if (rec_buffers[i].buf == buf)
+      return &rec_buffers[i];
+  return NULL;
+}
+
+static struct rec_buffer *rec_find_paddr(int paddr) {
+  struct g2d_buf *b;
+  int i;
+
+  for (i = 0; i < rec_buffer_count; i++) {
+    b = rec_buffers[i].buf;
+    if (paddr >= b->buf_paddr && paddr < b->buf_paddr + b->buf_size)
+      return &rec_buffers[i];
+  }
+  return NULL;
+}
+
+static uint32_t rec_buf_id(const struct g2d_buf *buf) {
+  struct rec_buffer *rb = buf ? rec_find_buf(buf) : NULL;
+
+  return rb ? rb->id : 0;
+}
+
+static uint32_t rec_add_buf(struct g2d_buf *buf) {
+  struct rec_buffer *grown;
+
+  if (rec_buffer_count == rec_buffer_max) {
+    grown = realloc(rec_buffers, sizeof(*grown) * (rec_buffer_max * 2 + 16));
+    if (!grown)
+      return 0;
+    rec_buffers = grown;
+    rec_buffer_max = rec_buffer_max * 2 + 16;
+  }
+
+  rec_buffers[rec_buffer_count].buf = buf;
+  rec_buffers[rec_buffer_count].id = rec_next_id;
+  rec_buffers[rec_buffer_count].snapshot_done = 0;
+  rec_buffer_count++;
+
+  return rec_next_id++;
+}
+
+static uint32_t rec_remove_buf(const struct g2d_buf *buf) {
+  struct rec_buffer *rb = buf ? rec_find_buf(buf) : NULL;
+  uint32_t id;
+
+  if (!rb)
+    return 0;
+
+  id = rb->id;
+  *rb = rec_buffers[--rec_buffer_count];
+  return id;
+}
+
+static void rec_snapshot(struct rec_buffer *rb) {
+  struct record_snapshot snap;
+  uint64_t t;
+
+  if (!rb || rb->snapshot_done || !rb->buf->buf_vaddr)
+    return;
+
+  rb->snapshot_done = 1;
+  snap.id = rb->id;
+  snap.size = rb->buf->buf_size;
+
+  t = rec_now_ns();
+  rec_put_header(REC_SNAPSHOT, NULL, t, t, 0, sizeof(snap) + snap.size);
+  rec_put(&snap, sizeof(snap));
+  rec_put(rb->buf->buf_vaddr, snap.size);
+  rec_self_ns += rec_now_ns() - t;
+}
+
+static void rec_snapshot_surface(const struct g2d_surface *s) {
+  int i;
+
+  if (!rec_snapshots)
+    return;
+
+  for (i = 0; i < 3; i++)
+    if (s->planes[i])
+      rec_snapshot(rec_find_paddr(s->planes[i]));
+}
+
+static void rec_surface(struct record_surface *r, const struct g2d_surface *s) {
+  r->format = s->format;
+  r->planes[0] = s->planes[0];
+  r->planes[1] = s->planes[1];
+  r->planes[2] = s->planes[2];
+  r->left = s->left;
+  r->top = s->top;
+  r->right = s->right;
+  r->bottom = s->bottom;
+  r->stride = s->stride;
+  r->width = s->width;
+  r->height = s->height;
+  r->blendfunc = s->blendfunc;
+  r->global_alpha = s->global_alpha;
+  r->clrcolor = s->clrcolor;
+  r->rot = s->rot;
+}
+
+static void rec_surfaceEx(struct record_surfaceEx *r,
+                          const struct g2d_surfaceEx *s) {
+  rec_surface(&r->base, &s->base);
+  r->tiling = s->tiling;
+  r->ts_addr = s->ts.ts_addr;
+  r->fc_enabled = s->ts.fc_enabled;
+  r->fc_value = s->ts.fc_value;
+  r->fc_value_upper = s->ts.fc_value_upper;
+}
+
+/* Writes one record and accounts for the time spent recording it. */
+static void rec_emit(enum record_op op, void *handle, uint64_t start,
+                     uint64_t end, int ret, const void *payload,
+                     uint32_t size) {
+  uint64_t t = rec_now_ns();
+
+  pthread_mutex_lock(&rec_lock);
+  rec_put_header(op, handle, start, end, ret, size);
+  if (size)
+    rec_put(payload, size);
+  rec_calls++;
+  rec_g2d_ns += end - start;
+  rec_self_ns += rec_now_ns() - t;
+  pthread_mutex_unlock(&rec_lock);
+}
+
+__attribute__((constructor)) static void rec_init(void) {
+  const char *path = getenv(RECORD_FILE_ENV);
+  const char *snap = getenv(RECORD_SNAPSHOT_ENV);
+  struct record_file_header fh;
+
+  if (!path || !*path)
+    return;
+
+  rec_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (rec_fd < 0) {
+    fprintf(stderr, "g2d_record: FAILED to open %s: %s\n", path,
+            strerror(errno));
+    return;
+  }
+
+  rec_snapshots = snap && atoi(snap) > 0;
+
+  /* fault the stream buffers in now rather than during the first calls */
+  memset(rec_data, 0, sizeof(rec_data));
+  rec_start_ns = rec_now_ns();
+
+  memset(&fh, 0, sizeof(fh));
+  memcpy(fh.magic, RECORD_MAGIC, sizeof(fh.magic));
+  fh.version = RECORD_VERSION;
+  fh.header_size = sizeof(struct record_header);
+  fh.start_ns = rec_start_ns;
+  rec_write_all((const char *)&fh, sizeof(fh));
+
+  if (pthread_create(&rec_writer, NULL, rec_writer_main, NULL)) {
+    fprintf(stderr, "g2d_record: FAILED to start the writer thread\n");
+    close(rec_fd);
+    rec_fd = -1;
+  }
+}
+
+__attribute__((destructor)) static void rec_exit(void) {
+  if (rec_fd < 0)
+    return;
+
+  pthread_mutex_lock(&rec_lock);
+  if (rec_fill)
+    rec_swap();
+  rec_stop = 1;
+  pthread_cond_signal(&rec_full);
+  pthread_mutex_unlock(&rec_lock);
+
+  pthread_join(rec_writer, NULL);
+  close(rec_fd);
+  rec_fd = -1;
+
+  fprintf(stderr,
+          "g2d_record: %llu calls, %.1fKB, recording took %.1fus "
+          "(%.2f%% of %.1fus in g2d)\n",
+          rec_calls, rec_bytes / 1024.0, rec_self_ns / 1e3,
+          rec_g2d_ns ? 100.0 * rec_self_ns / rec_g2d_ns : 0, rec_g2d_ns / 1e3);
+}
+
+int g2d_open(void **handle) {
+  static int (*real)(void **);
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_open");
+  if (rec_fd < 0)
+    return real(handle);
+
+  t = rec_now_ns();
+  ret = real(handle);
+  rec_emit(REC_OPEN, ret ? NULL : *handle, t, rec_now_ns(), ret, NULL, 0);
+  return ret;
+}
+
+int g2d_close(void *handle) {
+  static int (*real)(void *);
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_close");
+  if (rec_fd < 0)
+    return real(handle);
+
+  t = rec_now_ns();
+  ret = real(handle);
+  rec_emit(REC_CLOSE, handle, t, rec_now_ns(), ret, NULL, 0);
+  return ret;
+}
+
+int g2d_make_current(void *handle, enum g2d_hardware_type type) {
+  static int (*real)(void *, enum g2d_hardware_type);
+  struct record_value v = {type, 0};
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_make_current");
+  if (rec_fd < 0)
+    return real(handle, type);
+
+  t = rec_now_ns();
+  ret = real(handle, type);
+  rec_emit(REC_MAKE_CURRENT, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_clear(void *handle, struct g2d_surface *area) {
+  static int (*real)(void *, struct g2d_surface *);
+  struct record_surface s;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_clear");
+  if (rec_fd < 0)
+    return real(handle, area);
+
+  if (rec_snapshots) {
+    pthread_mutex_lock(&rec_lock);
+    rec_snapshot_surface(area);
+    pthread_mutex_unlock(&rec_lock);
+  }
+
+  t = rec_now_ns();
+  ret = real(handle, area);
+  rec_surface(&s, area);
+  rec_emit(REC_CLEAR, handle, t, rec_now_ns(), ret, &s, sizeof(s));
+  return ret;
+}
+
+int g2d_blit(void *handle, struct g2d_surface *src, struct g2d_surface *dst) {
+  static int (*real)(void *, struct g2d_surface *, struct g2d_surface *);
+  struct record_surface s[2];
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_blit");
+  if (rec_fd < 0)
+    return real(handle, src, dst);
+
+  if (rec_snapshots) {
+    pthread_mutex_lock(&rec_lock);
+    rec_snapshot_surface(src);
+    rec_snapshot_surface(dst);
+    pthread_mutex_unlock(&rec_lock);
+  }
+
+  t = rec_now_ns();
+  ret = real(handle, src, dst);
+  rec_surface(&s[0], src);
+  rec_surface(&s[1], dst);
+  rec_emit(REC_BLIT, handle, t, rec_now_ns(), ret, s, sizeof(s));
+  return ret;
+}
+
+int g2d_blitEx(void *handle, struct g2d_surfaceEx *srcEx,
+               struct g2d_surfaceEx *dstEx) {
+  static int (*real)(void *, struct g2d_surfaceEx *, struct g2d_surfaceEx *);
+  struct record_surfaceEx s[2];
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_blitEx");
+  if (rec_fd < 0)
+    return real(handle, srcEx, dstEx);
+
+  if (rec_snapshots) {
+    pthread_mutex_lock(&rec_lock);
+    rec_snapshot_surface(&srcEx->base);
+    rec_snapshot_surface(&dstEx->base);
+    pthread_mutex_unlock(&rec_lock);
+  }
+
+  t = rec_now_ns();
+  ret = real(handle, srcEx, dstEx);
+  rec_surfaceEx(&s[0], srcEx);
+  rec_surfaceEx(&s[1], dstEx);
+  rec_emit(REC_BLITEX, handle, t, rec_now_ns(), ret, s, sizeof(s));
+  return ret;
+}
+
+int g2d_copy(void *handle, struct g2d_buf *d, struct g2d_buf *s, int size) {
+  static int (*real)(void *, struct g2d_buf *, struct g2d_buf *, int);
+  struct record_copy c;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_copy");
+  if (rec_fd < 0)
+    return real(handle, d, s, size);
+
+  pthread_mutex_lock(&rec_lock);
+  c.dst = rec_buf_id(d);
+  c.src = rec_buf_id(s);
+  if (rec_snapshots)
+    rec_snapshot(rec_find_buf(s));
+  pthread_mutex_unlock(&rec_lock);
+  c.size = size;
+  c.reserved = 0;
+
+  t = rec_now_ns();
+  ret = real(handle, d, s, size);
+  rec_emit(REC_COPY, handle, t, rec_now_ns(), ret, &c, sizeof(c));
+  return ret;
+}
+
+int g2d_multi_blit(void *handle, struct g2d_surface_pair *sp[], int layers) {
+  static int (*real)(void *, struct g2d_surface_pair *[], int);
+  struct record_multi_blit m = {layers, 0};
+  struct record_surface s[2];
+  uint64_t t, end;
+  int i, ret;
+
+  if (!real)
+    real = rec_resolve("g2d_multi_blit");
+  if (rec_fd < 0)
+    return real(handle, sp, layers);
+
+  if (rec_snapshots) {
+    pthread_mutex_lock(&rec_lock);
+    for (i = 0; i < layers; i++) {
+      rec_snapshot_surface(&sp[i]->s);
+      rec_snapshot_surface(&sp[i]->d);
+    }
+    pthread_mutex_unlock(&rec_lock);
+  }
+
+  t = rec_now_ns();
+  ret = real(handle, sp, layers);
+  end = rec_now_ns();
+
+  /* variable length, so the record is assembled in place */
+  pthread_mutex_lock(&rec_lock);
+  rec_put_header(REC_MULTI_BLIT, handle, t, end, ret,
+                 sizeof(m) + layers * sizeof(s));
+  rec_put(&m, sizeof(m));
+  for (i = 0; i < layers; i++) {
+    rec_surface(&s[0], &sp[i]->s);
+    rec_surface(&s[1], &sp[i]->d);
+    rec_put(s, sizeof(s));
+  }
+  rec_calls++;
+  rec_g2d_ns += end - t;
+  rec_self_ns += rec_now_ns() - end;
+  pthread_mutex_unlock(&rec_lock);
+
+  return ret;
+}
+
+int g2d_query_hardware(void *handle, enum g2d_hardware_type type,
+                       int *available) {
+  static int (*real)(void *, enum g2d_hardware_type, int *);
+  struct record_value v;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_query_hardware");
+  if (rec_fd < 0)
+    return real(handle, type, available);
+
+  t = rec_now_ns();
+  ret = real(handle, type, available);
+  v.arg = type;
+  v.result = available ? *available : 0;
+  rec_emit(REC_QUERY_HARDWARE, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_query_feature(void *handle, enum g2d_feature feature, int *available) {
+  static int (*real)(void *, enum g2d_feature, int *);
+  struct record_value v;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_query_feature");
+  if (rec_fd < 0)
+    return real(handle, feature, available);
+
+  t = rec_now_ns();
+  ret = real(handle, feature, available);
+  v.arg = feature;
+  v.result = available ? *available : 0;
+  rec_emit(REC_QUERY_FEATURE, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_query_cap(void *handle, enum g2d_cap_mode cap, int *enable) {
+  static int (*real)(void *, enum g2d_cap_mode, int *);
+  struct record_value v;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_query_cap");
+  if (rec_fd < 0)
+    return real(handle, cap, enable);
+
+  t = rec_now_ns();
+  ret = real(handle, cap, enable);
+  v.arg = cap;
+  v.result = enable ? *enable : 0;
+  rec_emit(REC_QUERY_CAP, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_enable(void *handle, enum g2d_cap_mode cap) {
+  static int (*real)(void *, enum g2d_cap_mode);
+  struct record_value v = {cap, 1};
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_enable");
+  if (rec_fd < 0)
+    return real(handle, cap);
+
+  t = rec_now_ns();
+  ret = real(handle, cap);
+  rec_emit(REC_ENABLE, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_disable(void *handle, enum g2d_cap_mode cap) {
+  static int (*real)(void *, enum g2d_cap_mode);
+  struct record_value v = {cap, 0};
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_disable");
+  if (rec_fd < 0)
+    return real(handle, cap);
+
+  t = rec_now_ns();
+  ret = real(handle, cap);
+  rec_emit(REC_DISABLE, handle, t, rec_now_ns(), ret, &v, sizeof(v));
+  return ret;
+}
+
+int g2d_cache_op(struct g2d_buf *buf, enum g2d_cache_mode op) {
+  static int (*real)(struct g2d_buf *, enum g2d_cache_mode);
+  struct record_buf_ref r;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_cache_op");
+  if (rec_fd < 0)
+    return real(buf, op);
+
+  pthread_mutex_lock(&rec_lock);
+  r.id = rec_buf_id(buf);
+  pthread_mutex_unlock(&rec_lock);
+  r.arg = op;
+
+  t = rec_now_ns();
+  ret = real(buf, op);
+  rec_emit(REC_CACHE_OP, NULL, t, rec_now_ns(), ret, &r, sizeof(r));
+  return ret;
+}
+
+/* Registers a new buffer and records its creation. */
+static void rec_new_buf(enum record_op op, struct g2d_buf *buf, uint64_t start,
+                        int size, int cacheable, int fd) {
+  struct record_buffer r;
+  uint64_t end = rec_now_ns();
+
+  memset(&r, 0, sizeof(r));
+  r.size = size;
+  r.cacheable = cacheable;
+  r.fd = fd;
+  if (buf) {
+    r.size = buf->buf_size;
+    r.paddr = buf->buf_paddr;
+    r.vaddr = (uint64_t)(uintptr_t)buf->buf_vaddr;
+  }
+
+  pthread_mutex_lock(&rec_lock);
+  if (buf)
+    r.id = rec_add_buf(buf);
+  rec_put_header(op, NULL, start, end, buf ? 0 : -1, sizeof(r));
+  rec_put(&r, sizeof(r));
+  rec_calls++;
+  rec_g2d_ns += end - start;
+  rec_self_ns += rec_now_ns() - end;
+  pthread_mutex_unlock(&rec_lock);
+}
+
+struct g2d_buf *g2d_alloc(int size, int cacheable) {
+  static struct g2d_buf *(*real)(int, int);
+  struct g2d_buf *buf;
+  uint64_t t;
+
+  if (!real)
+    real = rec_resolve("g2d_alloc");
+  if (rec_fd < 0)
+    return real(size, cacheable);
+
+  t = rec_now_ns();
+  buf = real(size, cacheable);
+  rec_new_buf(REC_ALLOC, buf, t, size, cacheable, -1);
+  return buf;
+}
+
+struct g2d_buf *g2d_buf_from_fd(int fd) {
+  static struct g2d_buf *(*real)(int);
+  struct g2d_buf *buf;
+  uint64_t t;
+
+  if (!real)
+    real = rec_resolve("g2d_buf_from_fd");
+  if (rec_fd < 0)
+    return real(fd);
+
+  t = rec_now_ns();
+  buf = real(fd);
+  rec_new_buf(REC_BUF_FROM_FD, buf, t, 0, -1, fd);
+  return buf;
+}
+
+int g2d_buf_export_fd(struct g2d_buf *buf) {
+  static int (*real)(struct g2d_buf *);
+  struct record_buf_ref r;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_buf_export_fd");
+  if (rec_fd < 0)
+    return real(buf);
+
+  pthread_mutex_lock(&rec_lock);
+  r.id = rec_buf_id(buf);
+  pthread_mutex_unlock(&rec_lock);
+  r.arg = 0;
+
+  t = rec_now_ns();
+  ret = real(buf);
+  rec_emit(REC_BUF_EXPORT_FD, NULL, t, rec_now_ns(), ret, &r, sizeof(r));
+  return ret;
+}
+
+struct g2d_buf *g2d_buf_from_virt_addr(void *vaddr, int size) {
+  static struct g2d_buf *(*real)(void *, int);
+  struct g2d_buf *buf;
+  uint64_t t;
+
+  if (!real)
+    real = rec_resolve("g2d_buf_from_virt_addr");
+  if (rec_fd < 0)
+    return real(vaddr, size);
+
+  t = rec_now_ns();
+  buf = real(vaddr, size);
+  rec_new_buf(REC_BUF_FROM_VIRT_ADDR, buf, t, size, -1, -1);
+  return buf;
+}
+
+int g2d_free(struct g2d_buf *buf) {
+  static int (*real)(struct g2d_buf *);
+  struct record_buf_ref r = {0, 0};
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_free");
+  if (rec_fd < 0)
+    return real(buf);
+
+  pthread_mutex_lock(&rec_lock);
+  r.id = rec_remove_buf(buf);
+  pthread_mutex_unlock(&rec_lock);
+
+  t = rec_now_ns();
+  ret = real(buf);
+  rec_emit(REC_FREE, NULL, t, rec_now_ns(), ret, &r, sizeof(r));
+  return ret;
+}
+
+int g2d_flush(void *handle) {
+  static int (*real)(void *);
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_flush");
+  if (rec_fd < 0)
+    return real(handle);
+
+  t = rec_now_ns();
+  ret = real(handle);
+  rec_emit(REC_FLUSH, handle, t, rec_now_ns(), ret, NULL, 0);
+  return ret;
+}
+
+int g2d_finish(void *handle) {
+  static int (*real)(void *);
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_finish");
+  if (rec_fd < 0)
+    return real(handle);
+
+  t = rec_now_ns();
+  ret = real(handle);
+  rec_emit(REC_FINISH, handle, t, rec_now_ns(), ret, NULL, 0);
+  return ret;
+}
+
+int g2d_set_warp_coordinates(void *handle, struct g2d_warp_coordinates *info) {
+  static int (*real)(void *, struct g2d_warp_coordinates *);
+  struct record_warp w;
+  uint64_t t;
+  int ret;
+
+  if (!real)
+    real = rec_resolve("g2d_set_warp_coordinates");
+  if (rec_fd < 0)
+    return real(handle, info);
+
+  memset(&w, 0, sizeof(w));
+  if (info) {
+    w.addr = info->addr;
+    w.width = info->width;
+    w.height = info->height;
+    w.format = info->format;
+    w.bpp = info->bpp;
+    w.arb_start_x = info->arb_start_x;
+    w.arb_start_y = info->arb_start_y;
+    w.arb_delta_xx = info->arb_delta_xx;
+    w.arb_delta_xy = info->arb_delta_xy;
+    w.arb_delta_yx = info->arb_delta_yx;
+    w.arb_delta_yy = info->arb_delta_yy;
+  }
+
+  t = rec_now_ns();
+  ret = real(handle, info);
+  rec_emit(REC_SET_WARP_COORDINATES, handle, t, rec_now_ns(), ret, &w,
+           sizeof(w));
+  return ret;
+}
@@ -0,0 +1,656 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_replay.c
+ *
+ * Replays a trace recorded with libg2d_record.so: recreates the buffers,
+ * restores their snapshots and issues the same g2d calls, either as fast as
+ * possible or with the recorded pacing. Reports the replay time of each op
+ * type next to the recorded one, and the frame times, a frame ending with
+ * each g2d_finish.
+ *
+ * Calls from all threads are replayed in recorded order on one thread.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "g2d.h"
+#include "g2dExt.h"
+#include "g2d_bench.h"
+#include "g2d_record.h"
+
+#define MAX_HANDLES 16
+
+static const char *op_names[REC_OP_COUNT] = {
+    [REC_OPEN] = "g2d_open",
+    [REC_CLOSE] = "g2d_close",
+    [REC_MAKE_CURRENT] = "g2d_make_current",
+    [REC_CLEAR] = "g2d_clear",
+    [REC_BLIT] = "g2d_blit",
+    [REC_BLITEX] = "g2d_blitEx",
+    [REC_COPY] = "g2d_copy",
+    [REC_MULTI_BLIT] = "g2d_multi_blit",
+    [REC_QUERY_HARDWARE] = "g2d_query_hardware",
+    [REC_QUERY_FEATURE] = "g2d_query_feature",
+    [REC_QUERY_CAP] = "g2d_query_cap",
+    [REC_ENABLE] = "g2d_enable",
+    [REC_DISABLE] = "g2d_disable",
+    [REC_CACHE_OP] = "g2d_cache_op",
+    [REC_ALLOC] = "g2d_alloc",
+    [REC_BUF_FROM_FD] = "g2d_buf_from_fd",
+    [REC_BUF_EXPORT_FD] = "g2d_buf_export_fd",
+    [REC_BUF_FROM_VIRT_ADDR] = "g2d_buf_from_virt_addr",
+    [REC_FREE] = "g2d_free",
+    [REC_FLUSH] = "g2d_flush",
+    [REC_FINISH] = "g2d_finish",
+    [REC_SET_WARP_COORDINATES] = "g2d_set_warp_coordinates",
+    [REC_SNAPSHOT] = "snapshot",
+};
+
+/* A recorded buffer and the one standing for it during the replay. */
+struct replay_buffer {
+  uint32_t id; /* 0 for the memory used by surfaces but never allocated */
+  int paddr;   /* physical address in the recording */
+  int size;
+  struct g2d_buf *buf;
+};
+
+struct replay_handle {
+  uint64_t recorded;
+  void *handle;
+};
+
+struct op_samples {
+  double *replay_us;
+  int count;
+  int max;
+  double recorded_us;
+};
+
+struct replay {
+  struct replay_buffer *buffers;
+  int buffer_count;
+  int buffer_max;
+  int scratch;
+  struct replay_handle handles[MAX_HANDLES];
+  int handle_count;
+  int skipped;
+  int bad;
+  int verbose;
+
+  struct op_samples ops[REC_OP_COUNT];
+  struct op_samples frames;
+};
+
+static const struct option longOptions[] = {
+    {"help", no_argument, NULL, 'h'},
+    {"pace", no_argument, NULL, 'p'},
+    {"verbose", no_argument, NULL, 'v'},
+    {NULL, 0, NULL, 0}};
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [options] trace\n"
+          "  -p, --pace     keep the recorded time between calls\n"
+          "  -v, --verbose  print the time of every replayed call\n"
+          "  -h, --help     show this message\n",
+          name);
+}
+
+static int add_sample(struct op_samples *s, double us) {
+  double *grown;
+
+  if (s->count == s->max) {
+    grown = realloc(s->replay_us, sizeof(double) * (s->max * 2 + 64));
+    if (!grown)
+      return -ENOMEM;
+    s->replay_us = grown;
+    s->max = s->max * 2 + 64;
+  }
+  s->replay_us[s->count++] = us;
+  return 0;
+}
+
+static struct replay_buffer *add_buffer(struct replay *r, uint32_t id,
+                                        int paddr, int size, int cacheable) {
+  struct replay_buffer *grown, *rb;
+
+  if (r->buffer_count == r->buffer_max) {
+    grown = realloc(r->buffers, sizeof(*grown) * (r->buffer_max * 2 + 16));
+    if (!grown)
+      return NULL;
+    r->buffers = grown;
+    r->buffer_max = r->buffer_max * 2 + 16;
+  }
+
+  rb = &r->buffers[r->buffer_count++];
+  rb->id = id;
+  rb->paddr = paddr;
+  rb->size = size;
+  rb->buf = g2d_alloc(size, cacheable);
+  if (!rb->buf) {
+    printf("g2d_alloc %d bytes fail\n", size);
+    r->buffer_count--;
+    return NULL;
+  }
+  return rb;
+}
+
+static struct replay_buffer *find_id(struct replay *r, uint32_t id) {
+  int i;
+
+  for (i = 0; id && i < r->buffer_count; i++)
+    if (r->buffers[i].id == id)
+      return &r->buffers[i];
+  return NULL;
+}
+
+static struct replay_buffer *find_paddr(struct replay *r, int paddr) {
+  int i;
+
+  for (i = 0; i < r->buffer_count; i++)
+    if (paddr >= r->buffers[i].paddr &&
+        paddr < r->buffers[i].paddr + r->buffers[i].size)
+      return &r->buffers[i];
+  return NULL;
+}
+
+/*
+ * Translates a recorded physical address. Memory that was not allocated
+ * through g2d in the recording, e.g. a framebuffer, gets a scratch buffer
+ * large enough for the surface using it.
+ */
+static int map_paddr(struct replay *r, int paddr, int extent) {
+  struct replay_buffer *rb;
+
+  if (!paddr)
+    return 0;
+
+  rb = find_paddr(r, paddr);
+  if (!rb) {
+    rb = add_buffer(r, 0, paddr, extent, 0);
+    if (!rb)
+      return 0;
+    r->scratch++;
+  }
+  return rb->buf->buf_paddr + (paddr - rb->paddr);
+}
+
+static void map_surface(struct replay *r, struct g2d_surface *s,
+                        const struct record_surface *rs) {
+  /* 4 bytes per pixel covers every format and its chroma planes */
+  int extent = rs->stride * rs->height * 4;
+  int i;
+
+  s->format = rs->format;
+  for (i = 0; i < 3; i++)
+    s->planes[i] = map_paddr(r, rs->planes[i], extent);
+  s->left = rs->left;
+  s->top = rs->top;
+  s->right = rs->right;
+  s->bottom = rs->bottom;
+  s->stride = rs->stride;
+  s->width = rs->width;
+  s->height = rs->height;
+  s->blendfunc = rs->blendfunc;
+  s->global_alpha = rs->global_alpha;
+  s->clrcolor = rs->clrcolor;
+  s->rot = rs->rot;
+}
+
+static void map_surfaceEx(struct replay *r, struct g2d_surfaceEx *s,
+                          const struct record_surfaceEx *rs) {
+  memset(s, 0, sizeof(*s));
+  map_surface(r, &s->base, &rs->base);
+  s->tiling = rs->tiling;
+  s->ts.ts_addr = rs->ts_addr;
+  s->ts.fc_enabled = rs->fc_enabled;
+  s->ts.fc_value = rs->fc_value;
+  s->ts.fc_value_upper = rs->fc_value_upper;
+}
+
+/* Returns the handle replaying the recorded one, NULL if never opened. */
+static void *find_handle(struct replay *r, uint64_t recorded) {
+  int i;
+
+  for (i = 0; i < r->handle_count; i++)
+    if (r->handles[i].recorded == recorded)
+      return r->handles[i].handle;
+  return NULL;
+}
+
+static void unmap_handle(struct replay *r, uint64_t recorded) {
+  int i;
+
+  for (i = 0; i < r->handle_count; i++) {
+    if (r->handles[i].recorded == recorded) {
+      r->handles[i] = r->handles[--r->handle_count];
+      return;
+    }
+  }
+}
+
+static void create_buffer(struct replay *r, const struct record_buffer *b) {
+  if (!b->id)
+    return;
+
+  /* imported memory cannot be recreated, a g2d buffer stands for it */
+  if (!add_buffer(r, b->id, b->paddr, b->size, b->cacheable > 0))
+    r->skipped++;
+}
+
+static void free_buffer(struct replay *r, uint32_t id) {
+  struct replay_buffer *rb = find_id(r, id);
+
+  if (!rb)
+    return;
+  if (rb->buf)
+    g2d_free(rb->buf);
+  *rb = r->buffers[--r->buffer_count];
+}
+
+/* Smallest payload of each op, the surfaces of a multiblit come on top. */
+static const size_t payload_sizes[REC_OP_COUNT] = {
+    [REC_MAKE_CURRENT] = sizeof(struct record_value),
+    [REC_CLEAR] = sizeof(struct record_surface),
+    [REC_BLIT] = 2 * sizeof(struct record_surface),
+    [REC_BLITEX] = 2 * sizeof(struct record_surfaceEx),
+    [REC_COPY] = sizeof(struct record_copy),
+    [REC_MULTI_BLIT] = sizeof(struct record_multi_blit),
+    [REC_QUERY_HARDWARE] = sizeof(struct record_value),
+    [REC_QUERY_FEATURE] = sizeof(struct record_value),
+    [REC_QUERY_CAP] = sizeof(struct record_value),
+    [REC_ENABLE] = sizeof(struct record_value),
+    [REC_DISABLE] = sizeof(struct record_value),
+    [REC_CACHE_OP] = sizeof(struct record_buf_ref),
+    [REC_ALLOC] = sizeof(struct record_buffer),
+    [REC_BUF_FROM_FD] = sizeof(struct record_buffer),
+    [REC_BUF_EXPORT_FD] = sizeof(struct record_buf_ref),
+    [REC_BUF_FROM_VIRT_ADDR] = sizeof(struct record_buffer),
+    [REC_FREE] = sizeof(struct record_buf_ref),
+    [REC_SET_WARP_COORDINATES] = sizeof(struct record_warp),
+    [REC_SNAPSHOT] = sizeof(struct record_snapshot),
+};
+
+static int multi_blit_layers(const struct record_multi_blit *m) {
+  return m->layers < 0 ? 0 : m->layers < 32 ? m->layers : 32;
+}
+
+/* Returns 0 if the payload of h is shorter than what its op reads. */
+static int payload_complete(const struct record_header *h,
+                            const char *payload) {
+  const struct record_multi_blit *m = (const void *)payload;
+  const struct record_snapshot *snap = (const void *)payload;
+
+  if (h->size < payload_sizes[h->op])
+    return 0;
+  if (h->op == REC_MULTI_BLIT)
+    return h->size >= sizeof(*m) + 2 * multi_blit_layers(m) *
+                                       sizeof(struct record_surface);
+  if (h->op == REC_SNAPSHOT)
+    return snap->size >= 0 && h->size >= sizeof(*snap) + snap->size;
+  return 1;
+}
+
+/*
+ * Issues one recorded call. Returns 1 if the call was replayed, 0 if it was
+ * skipped for a buffer which was not recorded, and -1 for an unknown op or
+ * a handle without a REC_OPEN.
+ */
+static int replay_op(struct replay *r, const struct record_header *h,
+                     const char *payload) {
+  const struct record_surface *rs = (const void *)payload;
+  const struct record_surfaceEx *rsx = (const void *)payload;
+  const struct record_value *v = (const void *)payload;
+  const struct record_buf_ref *ref = (const void *)payload;
+  const struct record_copy *c = (const void *)payload;
+  const struct record_multi_blit *m = (const void *)payload;
+  const struct record_warp *rw = (const void *)payload;
+  struct g2d_surface s, d;
+  struct g2d_surfaceEx sx, dx;
+  struct g2d_surface_pair *pairs[32], pair_data[32];
+  struct g2d_warp_coordinates warp;
+  struct replay_buffer *rb, *rb2;
+  void *handle = NULL;
+  int i, layers, value;
+
+  switch (h->op) {
+  case REC_OPEN:
+    if (!h->ret && r->handle_count < MAX_HANDLES &&
+        !g2d_open(&r->handles[r->handle_count].handle))
+      r->handles[r->handle_count++].recorded = h->handle;
+    return 1;
+  case REC_ALLOC:
+  case REC_BUF_FROM_FD:
+  case REC_BUF_FROM_VIRT_ADDR:
+    create_buffer(r, (const struct record_buffer *)payload);
+    return 1;
+  case REC_FREE:
+    free_buffer(r, ref->id);
+    return 1;
+  case REC_CACHE_OP:
+    rb = find_id(r, ref->id);
+    if (!rb)
+      return 0;
+    g2d_cache_op(rb->buf, ref->arg);
+    return 1;
+  case REC_BUF_EXPORT_FD:
+    rb = find_id(r, ref->id);
+    if (!rb)
+      return 0;
+    value = g2d_buf_export_fd(rb->buf);
+    if (value >= 0)
+      close(value);
+    return 1;
+  case REC_CLOSE:
+  case REC_MAKE_CURRENT:
+  case REC_CLEAR:
+  case REC_BLIT:
+  case REC_BLITEX:
+  case REC_COPY:
+  case REC_MULTI_BLIT:
+  case REC_QUERY_HARDWARE:
+  case REC_QUERY_FEATURE:
+  case REC_QUERY_CAP:
+  case REC_ENABLE:
+  case REC_DISABLE:
+  case REC_FLUSH:
+  case REC_FINISH:
+  case REC_SET_WARP_COORDINATES:
+    break;
+  default:
+    return -1;
+  }
+
+  handle = find_handle(r, h->handle);
+  if (!handle)
+    return -1;
+
+  switch (h->op) {
+  case REC_CLOSE:
+    g2d_close(handle);
+    unmap_handle(r, h->handle);
+    break;
+  case REC_MAKE_CURRENT:
+    g2d_make_current(handle, v->arg);
+    break;
+  case REC_CLEAR:
+    map_surface(r, &d, rs);
+    g2d_clear(handle, &d);
+    break;
+  case REC_BLIT:
+    map_surface(r, &s, &rs[0]);
+    map_surface(r, &d, &rs[1]);
+    g2d_blit(handle, &s, &d);
+    break;
+  case REC_BLITEX:
+    map_surfaceEx(r, &sx, &rsx[0]);
+    map_surfaceEx(r, &dx, &rsx[1]);
+    g2d_blitEx(handle, &sx, &dx);
+    break;
+  case REC_COPY:
+    rb = find_id(r, c->dst);
+    rb2 = find_id(r, c->src);
+    if (!rb || !rb2)
+      return 0;
+    g2d_copy(handle, rb->buf, rb2->buf, c->size);
+    break;
+  case REC_MULTI_BLIT:
+    layers = multi_blit_layers(m);
+    rs = (const void *)(payload + sizeof(*m));
+    for (i = 0; i < layers; i++) {
+      map_surface(r, &pair_data[i].s, &rs[2 * i]);
+      map_surface(r, &pair_data[i].d, &rs[2 * i + 1]);
+      pairs[i] = &pair_data[i];
+    }
+    g2d_multi_blit(handle, pairs, layers);
+    break;
+  case REC_QUERY_HARDWARE:
+    g2d_query_hardware(handle, v->arg, &value);
+    break;
+  case REC_QUERY_FEATURE:
+    g2d_query_feature(handle, v->arg, &value);
+    break;
+  case REC_QUERY_CAP:
+    g2d_query_cap(handle, v->arg, &value);
+    break;
+  case REC_ENABLE:
+    g2d_enable(handle, v->arg);
+    break;
+  case REC_DISABLE:
+    g2d_disable(handle, v->arg);
+    break;
+  case REC_FLUSH:
+    g2d_flush(handle);
+    break;
+  case REC_FINISH:
+    g2d_finish(handle);
+    break;
+  case REC_SET_WARP_COORDINATES:
+    memset(&warp, 0, sizeof(warp));
+    warp.addr = map_paddr(r, rw->addr, rw->width * rw->height * 4);
+    warp.width = rw->width;
+    warp.height = rw->height;
+    warp.format = rw->format;
+    warp.bpp = rw->bpp;
+    warp.arb_start_x = rw->arb_start_x;
+    warp.arb_start_y = rw->arb_start_y;
+    warp.arb_delta_xx = rw->arb_delta_xx;
+    warp.arb_delta_xy = rw->arb_delta_xy;
+    warp.arb_delta_yx = rw->arb_delta_yx;
+    warp.arb_delta_yy = rw->arb_delta_yy;
+    g2d_set_warp_coordinates(handle, &warp);
+    break;
+  default:
+    return 0;
+  }
+
+  return 1;
+}
+
+static void restore_snapshot(struct replay *r, const char *payload) {
+  const struct record_snapshot *snap = (const void *)payload;
+  struct replay_buffer *rb = find_id(r, snap->id);
+
+  if (!rb || !rb->buf->buf_vaddr)
+    return;
+
+  memcpy(rb->buf->buf_vaddr, payload + sizeof(*snap),
+         snap->size < rb->size ? snap->size : rb->size);
+}
+
+static void print_results(struct replay *r, long long total_us, int calls) {
+  struct bench_stats st;
+  struct op_samples *s;
+  int i;
+
+  printf("\n---------------- replay: %d calls in %.1fms ----------------\n",
+         calls, total_us / 1e3);
+  printf("%-26s %8s %12s %12s %9s %9s %9s\n", "function", "calls",
+         "replay ms", "recorded ms", "med us", "p99 us", "max us");
+
+  for (i = 1; i < REC_OP_COUNT; i++) {
+    s = &r->ops[i];
+    if (!s->count)
+      continue;
+
+    bench_compute_stats(s->replay_us, s->count, &st);
+    printf("%-26s %8d %12.2f %12.2f %9.1f %9.1f %9.1f\n", op_names[i],
+           s->count, st.mean * st.count / 1e3, s->recorded_us / 1e3,
+           st.median, st.p99, st.max);
+  }
+
+  s = &r->frames;
+  if (s->count) {
+    bench_compute_stats(s->replay_us, s->count, &st);
+    printf("\n%d frames, frame time median %.1fus, p99 %.1fus, max %.1fus, "
+           "%.1ffps\n",
+           st.count, st.median, st.p99, st.max,
+           st.mean > 0 ? 1e6 / st.mean : 0);
+  }
+
+  if (r->scratch)
+    printf("%d scratch buffer(s) stood for memory allocated outside g2d\n",
+           r->scratch);
+  if (r->skipped)
+    printf("%d call(s) skipped, their buffers were not recorded\n",
+           r->skipped);
+  if (r->bad)
+    printf("%d bad record(s) skipped, unknown op or handle never opened\n",
+           r->bad);
+}
+
+int main(int argc, char *argv[]) {
+  struct record_file_header fh;
+  struct record_header h;
+  struct replay r;
+  char *payload = NULL, *grown;
+  size_t payload_max = 0;
+  long long start, t1, t2, frame_start, target;
+  uint64_t first_ns = 0;
+  int pace = 0, calls = 0, first = 1, corrupt = 0;
+  FILE *fp;
+  int i, ret;
+
+  memset(&r, 0, sizeof(r));
+
+  while (1) {
+    int optionIndex;
+    int ic = getopt_long(argc, argv, "hpv", longOptions, &optionIndex);
+    if (ic == -1)
+      break;
+
+    switch (ic) {
+    case 'h':
+      usage(argv[0]);
+      return 0;
+    case 'p':
+      pace = 1;
+      break;
+    case 'v':
+      r.verbose = 1;
+      break;
+    default:
+      usage(argv[0]);
+      return -EINVAL;
+    }
+  }
+
+  if (optind >= argc) {
+    usage(argv[0]);
+    return -EINVAL;
+  }
+
+  fp = fopen(argv[optind], "rb");
+  if (!fp) {
+    printf("FAILED to open trace %s\n", argv[optind]);
+    return -ENOENT;
+  }
+
+  if (fread(&fh, sizeof(fh), 1, fp) != 1 ||
+      memcmp(fh.magic, RECORD_MAGIC, sizeof(fh.magic)) ||
+      fh.version != RECORD_VERSION ||
+      fh.header_size != sizeof(struct record_header)) {
+    printf("%s is not a g2d trace of version %d\n", argv[optind],
+           RECORD_VERSION);
+    fclose(fp);
+    return -EINVAL;
+  }
+
+  start = frame_start = bench_get_time_us();
+
+  while (fread(&h, sizeof(h), 1, fp) == 1) {
+    if (h.size > payload_max) {
+      grown = realloc(payload, h.size);
+      if (!grown) {
+        printf("Fail to allocate %u bytes\n", h.size);
+        break;
+      }
+      payload = grown;
+      payload_max = h.size;
+    }
+    t1 = bench_get_time_us();
+    if (h.size && fread(payload, h.size, 1, fp) != 1) {
+      printf("trace truncated\n");
+      break;
+    }
+
+    if (h.op < REC_OP_COUNT && !payload_complete(&h, payload)) {
+      printf("corrupt trace: %u payload bytes for %s, replay stopped\n",
+             h.size, op_names[h.op] ? op_names[h.op] : "?");
+      corrupt = 1;
+      break;
+    }
+
+    /* restoring content is set up, not part of the timed replay */
+    if (h.op == REC_SNAPSHOT) {
+      restore_snapshot(&r, payload);
+      t2 = bench_get_time_us();
+      frame_start += t2 - t1;
+      start += t2 - t1;
+      continue;
+    }
+    if (h.op >= REC_OP_COUNT)
+      continue;
+
+    if (pace) {
+      if (first)
+        first_ns = h.start_ns;
+      target = start + (long long)(h.start_ns - first_ns) / 1000;
+      t1 = bench_get_time_us();
+      if (target > t1)
+        usleep(target - t1);
+    }
+    first = 0;
+
+    t1 = bench_get_time_us();
+    ret = replay_op(&r, &h, payload);
+    if (ret <= 0) {
+      if (ret < 0)
+        r.bad++;
+      else
+        r.skipped++;
+      continue;
+    }
+    t2 = bench_get_time_us();
+
+    calls++;
+    add_sample(&r.ops[h.op], (double)(t2 - t1));
+    r.ops[h.op].recorded_us += h.duration_ns / 1e3;
+
+    if (r.verbose)
+      printf("%8d %-26s %8lldus (recorded %.1fus)\n", calls, op_names[h.op],
+             t2 - t1, h.duration_ns / 1e3);
+
+    if (h.op == REC_FINISH) {
+      add_sample(&r.frames, (double)(t2 - frame_start));
+      frame_start = t2;
+    }
+  }
+
+  print_results(&r, bench_get_time_us() - start, calls);
+
+  for (i = 0; i < r.buffer_count; i++)
+    if (r.buffers[i].buf)
+      g2d_free(r.buffers[i].buf);
+  for (i = 0; i < r.handle_count; i++)
+    g2d_close(r.handles[i].handle);
+  for (i = 0; i < REC_OP_COUNT; i++)
+    free(r.ops[i].replay_us);
+  free(r.frames.replay_us);
+  free(r.buffers);
+  free(payload);
+  fclose(fp);
+
+  return corrupt ? -EINVAL : 0;
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_thread.c
+ *
+ * Runs T worker threads, each with its own g2d handle and buffers, doing
+ * blit / csc / resize loops, for T = 1, 2, 4, ... max threads. Reports the
+ * aggregate and per-thread throughput and the latency tail, so that lock
+ * contention or serialization in the driver stack shows up as poor scaling.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "g2d.h"
+#include "g2d_bench.h"
+
+#define TEST_WIDTH 1280
+#define TEST_HEIGHT 720
+#define TEST_LOOP 200
+#define MAX_THREADS 8
+#define THREAD_LIMIT 64
+
+enum op_type {
+  OP_BLIT,
+  OP_CSC,
+  OP_RESIZE,
+  OP_COUNT,
+  OP_MIX = OP_COUNT,
+};
+
+static const char *op_names[] = {
+    [OP_BLIT] = "blit",
+    [OP_CSC] = "csc",
+    [OP_RESIZE] = "resize",
+    [OP_MIX] = "mix",
+};
+
+struct worker {
+  pthread_t thread;
+  int index;
+  int width;
+  int height;
+  int loops;
+  enum op_type op;
+  pthread_barrier_t *barrier;
+  pthread_mutex_t *start_lock; /* held until barrier is sized */
+  const int *create_failed;
+
+  int ok;
+  long long elapsed_us;
+  long long pixels;
+  double *samples;
+  struct bench_stats latency;
+};
+
+static const struct option longOptions[] = {
+    {"help", no_argument, NULL, 'h'},
+    {"source", required_argument, NULL, 's'},
+    {"threads", required_argument, NULL, 't'},
+    {"loops", required_argument, NULL, 'n'},
+    {"op", required_argument, NULL, 'o'},
+    {NULL, 0, NULL, 0}};
+
+static void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -s, --source WIDTHxHEIGHT  surface size per thread (default "
+          "%dx%d)\n"
+          "  -t, --threads N            largest thread count (default %d)\n"
+          "  -n, --loops N              operations per thread (default %d)\n"
+          "  -o, --op blit|csc|resize|mix\n"
+          "                             operation to run (default mix)\n"
+          "  -h, --help                 show this message\n",
+          name, TEST_WIDTH, TEST_HEIGHT, MAX_THREADS, TEST_LOOP);
+}
+
+static void set_surface(struct g2d_surface *s, struct g2d_buf *buf, int width,
+                        int height, enum g2d_format format) {
+  memset(s, 0, sizeof(*s));
+  s->format = format;
+  s->planes[0] = buf->buf_paddr;
+  s->planes[1] = buf->buf_paddr + width * height;
+  s->right = width;
+  s->bottom = height;
+  s->stride = width;
+  s->width = width;
+  s->height = height;
+  s->rot = G2D_ROTATION_0;
+}
+
+static void *worker_main(void *arg) {
+  struct worker *w = arg;
+  struct g2d_surface src, dst;
+  struct g2d_buf *s_buf = NULL, *d_buf = NULL;
+  void *handle = NULL;
+  long long t1, t2, start;
+  int size = w->width * w->height * 4;
+  enum op_type op;
+  int i;
+
+  w->ok = 0;
+  if (g2d_open(&handle) == 0) {
+    s_buf = g2d_alloc(size, 0);
+    d_buf = g2d_alloc(size, 0);
+  }
+  if (!handle || !s_buf || !d_buf)
+    printf("thread %d: g2d_open/g2d_alloc fail\n", w->index);
+  else {
+    memset(s_buf->buf_vaddr, 0x80, size);
+    w->ok = 1;
+  }
+
+  pthread_mutex_lock(w->start_lock);
+  if (*w->create_failed)
+    w->ok = 0;
+  pthread_mutex_unlock(w->start_lock);
+
+  /* all threads start the timed loop together */
+  pthread_barrier_wait(w->barrier);
+
+  if (w->ok) {
+    start = bench_get_time_us();
+    for (i = 0; i < w->loops; i++) {
+      op = w->op == OP_MIX ? (enum op_type)(i % OP_COUNT) : w->op;
+
+      set_surface(&src, s_buf, w->width, w->height, G2D_RGBA8888);
+      set_surface(&dst, d_buf, w->width, w->height, G2D_RGBA8888);
+      if (op == OP_CSC)
+        src.format = G2D_YUYV;
+      else if (op == OP_RESIZE)
+        set_surface(&src, s_buf, w->width >> 1, w->height >> 1,
+                    G2D_RGBA8888);
+
+      t1 = bench_get_time_us();
+      g2d_blit(handle, &src, &dst);
+      g2d_finish(handle);
+      t2 = bench_get_time_us();
+
+      w->samples[i] = (double)(t2 - t1);
+      w->pixels += w->width * w->height;
+    }
+    w->elapsed_us = bench_get_time_us() - start;
+    bench_compute_stats(w->samples, w->loops, &w->latency);
+  }
+
+  if (s_buf)
+    g2d_free(s_buf);
+  if (d_buf)
+    g2d_free(d_buf);
+  if (handle)
+    g2d_close(handle);
+
+  return NULL;
+}
+
+/* Returns the aggregate throughput in ops/s, or a negative value on error. */
+static double run_threads(int threads, int width, int height, int loops,
+                          enum op_type op, double base) {
+  struct worker workers[THREAD_LIMIT];
+  pthread_barrier_t barrier;
+  pthread_mutex_t start_lock = PTHREAD_MUTEX_INITIALIZER;
+  double *all, rate, total_rate = 0;
+  struct bench_stats agg;
+  long long pixels = 0, wall = 0;
+  int i, n = 0, started, create_failed = 0;
+
+  all = malloc(sizeof(double) * loops * threads);
+  if (!all)
+    return -ENOMEM;
+
+  /* the barrier counts the threads actually created, the workers wait */
+  pthread_mutex_lock(&start_lock);
+  memset(workers, 0, sizeof(workers));
+  for (started = 0; started < threads; started++) {
+    workers[started].index = started;
+    workers[started].width = width;
+    workers[started].height = height;
+    workers[started].loops = loops;
+    workers[started].op = op;
+    workers[started].barrier = &barrier;
+    workers[started].start_lock = &start_lock;
+    workers[started].create_failed = &create_failed;
+    workers[started].samples = all + started * loops;
+    if (pthread_create(&workers[started].thread, NULL, worker_main,
+                       &workers[started])) {
+      printf("thread %d: pthread_create fail\n", started);
+      create_failed = 1;
+      break;
+    }
+  }
+  if (started)
+    pthread_barrier_init(&barrier, NULL, started);
+  pthread_mutex_unlock(&start_lock);
+
+  for (i = 0; i < started; i++)
+    pthread_join(workers[i].thread, NULL);
+
+  if (started)
+    pthread_barrier_destroy(&barrier);
+  if (create_failed) {
+    free(all);
+    return -EAGAIN;
+  }
+
+  printf("\n---------------- %d thread(s), %s ----------------\n", threads,
+         op_names[op]);
+  printf("%6s %10s %10s %10s %10s %10s\n", "thread", "ops/s", "Mpixel/s",
+         "p50 us", "p99 us", "max us");
+
+  for (i = 0; i < threads; i++) {
+    struct worker *w = &workers[i];
+
+    if (!w->ok || !w->elapsed_us)
+      continue;
+
+    rate = w->loops * 1e6 / w->elapsed_us;
+    total_rate += rate;
+    pixels += w->pixels;
+    if (w->elapsed_us > wall)
+      wall = w->elapsed_us;
+
+    printf("%6d %10.1f %10.1f %10.1f %10.1f %10.1f\n", i, rate,
+           w->pixels / (double)w->elapsed_us, w->latency.median,
+           w->latency.p99, w->latency.max);
+
+    /* gather the per-thread samples for the aggregate latency */
+    memmove(all + n, w->samples, sizeof(double) * w->loops);
+    n += w->loops;
+  }
+
+  if (!n) {
+    free(all);
+    return -EINVAL;
+  }
+
+  bench_compute_stats(all, n, &agg);
+  printf("%6s %10.1f %10.1f %10.1f %10.1f %10.1f\n", "all", total_rate,
+         pixels / (double)wall, agg.median, agg.p99, agg.max);
+  if (base > 0)
+    printf("scaling %.2fx over 1 thread, efficiency %.0f%%\n",
+           total_rate / base, 100.0 * total_rate / (base * threads));
+
+  free(all);
+  return total_rate;
+}
+
+int main(int argc, char *argv[]) {
+  int test_width = TEST_WIDTH, test_height = TEST_HEIGHT;
+  int max_threads = MAX_THREADS, loops = TEST_LOOP;
+  enum op_type op = OP_MIX;
+  double rate, base = 0;
+  int threads, next, i;
+
+  while (1) {
+    int optionIndex;
+    int ic = getopt_long(argc, argv, "hs:t:n:o:", longOptions, &optionIndex);
+    if (ic == -1)
+      break;
+
+    switch (ic) {
+    case 'h':
+      usage(argv[0]);
+      return 0;
+    case 's':
+      if (2 != sscanf(optarg, "%dx%d", &test_width, &test_height) ||
+          test_width <= 0 || test_height <= 0) {
+        fprintf(stderr, "Invalid size '%s', must be \"w x h\"\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 't':
+      if (1 != sscanf(optarg, "%d", &max_threads) || max_threads < 1 ||
+          max_threads > THREAD_LIMIT) {
+        fprintf(stderr, "Invalid thread count '%s'\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 'n':
+      if (1 != sscanf(optarg, "%d", &loops) || loops < 1) {
+        fprintf(stderr, "Invalid loops '%s'\n", optarg);
+        return -EINVAL;
+      }
+      break;
+    case 'o':
+      for (i = 0; i <= OP_MIX; i++)
+        if (!strcmp(optarg, op_names[i]))
+          break;
+      if (i > OP_MIX) {
+        fprintf(stderr, "Invalid op '%s'\n", optarg);
+        return -EINVAL;
+      }
+      op = i;
+      break;
+    default:
+      usage(argv[0]);
+      return -EINVAL;
+    }
+  }
+
+  test_width = (test_width + 15) & ~15;
+  test_height = (test_height + 15) & ~15;
+
+  printf("Width %d, Height %d, %d ops per thread, up to %d threads\n",
+         test_width, test_height, loops, max_threads);
+
+  for (threads = 1; threads <= max_threads; threads = next) {
+    rate = run_threads(threads, test_width, test_height, loops, op, base);
+    if (rate < 0) {
+      printf("%d thread(s) run failed\n", threads);
+      return -ENOTTY;
+    }
+    if (threads == 1)
+      base = rate;
+
+    /* double each step, but always finish on the requested count */
+    next = threads << 1;
+    if (threads < max_threads && next > max_threads)
+      next = max_threads;
+  }
+
+  return 0;
+}
@@ -20,6 +20,8 @@
 
 #include <g2dExt.h>
 
+#include "g2d_bench.h"
+
 #ifndef G2D_OPENCL
 #define G2D_OPENCL 1
 #endif
@@ -81,6 +83,7 @@ static const struct option longOptions[] = {
 int main(int argc, char *argv[]) {
   int i, j, diff = 0;
   struct timeval tv1, tv2;
+  struct bench_run run;
   int g2d_feature_available = 0;
   int test_width = 0, test_height = 0;
   void *handle = NULL;
@@ -95,6 +98,7 @@ int main(int argc, char *argv[]) {
     printf("g2d_open fail.\n");
     return -ENOTTY;
   }
+  bench_run_init(&run, TEST_LOOP);
 
   while (1) {
     int optionIndex;
@@ -219,18 +223,19 @@ int main(int argc, char *argv[]) {
 
   gettimeofday(&tv1, NULL);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_blitEx(handle, &srcEx, &dstEx);
   }
 
   g2d_finish(handle);
 
   gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  diff = bench_run_us(&run, (tv2.tv_sec - tv1.tv_sec) * 1000000LL +
+                                (tv2.tv_usec - tv1.tv_usec));
 
   printf("g2d tiling blit time %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_run_report(&run);
 
 #if G2D_OPENCL
   srcEx.base.format = G2D_NV12;
@@ -297,18 +302,19 @@ int main(int argc, char *argv[]) {
   printf("---------------- amphion tile2linear performance ----------------\n");
   gettimeofday(&tv1, NULL);
 
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, handle)) {
     g2d_blitEx(handle, &srcEx, &dstEx);
   }
 
   g2d_finish(handle);
 
   gettimeofday(&tv2, NULL);
-  diff = ((tv2.tv_sec - tv1.tv_sec) * 1000000 + (tv2.tv_usec - tv1.tv_usec)) /
-         TEST_LOOP;
+  diff = bench_run_us(&run, (tv2.tv_sec - tv1.tv_sec) * 1000000LL +
+                                (tv2.tv_usec - tv1.tv_usec));
 
   printf("g2d amphion tile2linear %dus, %dfps, %dMpixel/s ........\n", diff,
          1000000 / diff, test_width * test_height / diff);
+  bench_run_report(&run);
 #endif
 
   g2d_free(s_buf);
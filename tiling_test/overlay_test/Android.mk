@@ -4,7 +4,14 @@ LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 LOCAL_SRC_FILES := \
 	g2d_overlay_tile.c \
-	../../os/linux/gfx_fbdev.c
+	../../os/linux/gfx_fbdev.c \
+	../../common/g2d_asset.c \
+	../../common/g2d_cache_policy.c \
+	../../common/g2d_bench.c \
+	../../common/g2d_format.c \
+	../../common/g2d_trace.c \
+	../../common/g2d_alloc_stats.c \
+	../../common/g2d_cache_stats.c
 
 LOCAL_CFLAGS += -DBUILD_FOR_ANDROID -DIMX6Q -Wno-implicit-function-declaration
 
@@ -20,6 +27,7 @@ LOCAL_C_INCLUDES := $(LOCAL_PATH)
 
 LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)../../os/linux \
+	$(LOCAL_PATH)/../../common \
 	$(LOCAL_PATH)/../../include \
 	$(FSL_PROPRIETARY_PATH)/fsl-proprietary/include
 
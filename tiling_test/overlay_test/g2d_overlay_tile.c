@@ -32,14 +32,14 @@ extern "C" {
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "g2d_asset.h"
+#include "g2d_format.h"
 #include "gfx_init.h"
 #include <g2dExt.h>
 
 #define TFAIL -1
 #define TPASS 0
 
-#define CACHEABLE 0
-
 int g_buf_size;
 int g_buf_phys;
 
@@ -58,39 +58,10 @@ struct img_info {
 };
 
 struct g2d_buf *createG2DTextureBuf(char *filename) {
-  FILE *stream = NULL;
-  int size = 0;
-  struct g2d_buf *buf = NULL;
-  int len = 0;
-
-  stream = fopen(filename, "rb");
-  if (!stream) {
-    printf("Fail to open data file %s\n", filename);
-    return NULL;
-  }
-
-  fseek(stream, 0, SEEK_END);
-  size = ftell(stream);
-
-  fseek(stream, 0L, SEEK_SET);
-
-  // alloc physical contiguous memory for source image data
-  buf = g2d_alloc(size, CACHEABLE);
-  if (buf) {
-    len = fread((void *)buf->buf_vaddr, 1, size, stream);
-    if (len != size)
-      printf("fread %s error\n", filename);
-
-#if CACHEABLE
-    g2d_cache_op(buf, G2D_CACHE_FLUSH);
-#endif
-  }
-
-  fclose(stream);
-  return buf;
+  return asset_load(filename, CACHE_CPU_WRITE_ONCE);
 }
 
-void releaseG2DTextureBuf(struct g2d_buf *buf) { g2d_free(buf); }
+void releaseG2DTextureBuf(struct g2d_buf *buf) { asset_release(buf); }
 
 /*
  * generate a color bar, NV12 format
@@ -164,6 +135,7 @@ static void draw_image_to_framebuffer(
   struct g2d_surfaceEx srcEx, dstEx;
   struct g2d_surface *src = &srcEx.base;
   struct g2d_surface *dst = &dstEx.base;
+  struct format_layout layout;
 
   if (((left + dst_width) > (int)screen_info->xres) ||
       ((top + dst_height) > (int)screen_info->yres)) {
@@ -172,49 +144,22 @@ static void draw_image_to_framebuffer(
   }
 
   /*
-  NOTE: in this example, all the test image data meet with the alignment
-  requirement. Thus, in your code, you need to pay attention on that.
-
-  Pixel buffer address alignment requirement,
-  RGB/BGR: pixel data in planes [0] with 16bytes alignment,
-  NV12/NV16: Y in planes [0], UV in planes [1], with 64bytes alignment,
-  I420: Y in planes [0], U in planes [1], V in planes [2], with 64 bytes
-  alignment,
-  YV12: Y in planes [0], V in planes [1], U in planes [2], with 64 bytes
-  alignment,
-  NV21/NV61: Y in planes [0], VU in planes [1], with 64bytes alignment,
-  YUYV/YVYU/UYVY/VYUY: in planes[0], buffer address is with 16bytes alignment.
+  The raw test images hold their planes back to back. g2d_format.h gives the
+  plane address alignment each format requires, 16 bytes for RGB and packed
+  YUV and 64 bytes for each plane of NV12/NV16/I420, which the test images
+  meet. In your code, lay out the planes with format_alloc instead.
   */
 
   src->format = img_format;
-  switch (src->format) {
-  case G2D_RGB565:
-  case G2D_RGBA8888:
-  case G2D_RGBX8888:
-  case G2D_BGRA8888:
-  case G2D_BGRX8888:
-  case G2D_BGR565:
-  case G2D_YUYV:
-  case G2D_UYVY:
-    src->planes[0] = buf->buf_paddr;
-    break;
-  case G2D_NV12:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + img_width * img_height;
-    break;
-  case G2D_I420:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + img_width * img_height;
-    src->planes[2] = src->planes[1] + img_width * img_height / 4;
-    break;
-  case G2D_NV16:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + img_width * img_height;
-    break;
-  default:
+  if (format_layout(src->format, img_width, img_height, FORMAT_PACKED,
+                    &layout)) {
     printf("Unsupport source image format in the example code\n");
     return;
   }
+  if (!layout.aligned)
+    printf("%s image planes are not %d bytes aligned, off the fast path\n",
+           layout.desc->name, layout.desc->align);
+  format_set_planes(src, buf, &layout);
 
   srcEx.tiling = tiling;
   dstEx.tiling = G2D_LINEAR;
@@ -303,7 +248,8 @@ void Test_colorbar_vpu_tiled_to_linear(void *handle, int width, int height,
   struct g2d_buf *yuv_vpu_tiled_buf = NULL;
 
   yuv_linear_buf = g2d_alloc(width * height * 2, 0);
-  yuv_vpu_tiled_buf = g2d_alloc(width * height * 2, 0);
+  yuv_vpu_tiled_buf =
+      cache_policy_alloc(width * height * 2, CACHE_CPU_WRITE_ONCE);
 
   if (!yuv_linear_buf || !yuv_vpu_tiled_buf) {
     printf("Fail to allocate physical memory !\n");
@@ -320,6 +266,7 @@ void Test_colorbar_vpu_tiled_to_linear(void *handle, int width, int height,
   else if (tiling == G2D_LINEAR)
     memcpy(yuv_vpu_tiled_buf->buf_vaddr, yuv_linear_buf->buf_vaddr,
            width * height * 3 / 2);
+  cache_policy_cpu_done(yuv_vpu_tiled_buf);
 
   srcEx.tiling = tiling;
   dstEx.tiling = G2D_LINEAR;
@@ -357,8 +304,7 @@ void Test_colorbar_vpu_tiled_to_linear(void *handle, int width, int height,
 OnError:
   if (yuv_linear_buf)
     g2d_free(yuv_linear_buf);
-  if (yuv_vpu_tiled_buf)
-    g2d_free(yuv_vpu_tiled_buf);
+  cache_policy_free(yuv_vpu_tiled_buf);
 }
 
 static void Test_image_vpu_tiled_to_linear(void *handle, struct g2d_buf *buf,
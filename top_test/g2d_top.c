@@ -0,0 +1,232 @@
+/*
+ * Copyright 2026 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/*
+ * g2d_top.c
+ *
+ * Live view of the g2d statistics published by libg2d_prof.so when the
+ * application runs with G2D_STATS_SHM=1, refreshed every interval:
+ *
+ *   G2D_STATS_SHM=1 LD_PRELOAD=/opt/g2d_samples/libg2d_prof.so ./app &
+ *   ./g2d_top
+ *
+ * Rates and percentiles are computed from the counter deltas of the last
+ * interval only, the totals cover the whole run.
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "g2d_stats.h"
+
+#define SHM_DIR "/dev/shm"
+
+static void usage(const char *prog) {
+  printf("Usage: %s [-i ms] [-n count] [-l] [pid | /shm_name]\n", prog);
+  printf("  -i  refresh interval in ms, default 1000\n");
+  printf("  -n  number of refreshes, default until the process exits\n");
+  printf("  -l  list the processes publishing g2d statistics\n");
+  printf("Without argument the first process found in " SHM_DIR
+         " is shown.\n");
+}
+
+/* Returns the number of stats objects, the first one copied to name. */
+static int find_blocks(char *name, size_t len, int list) {
+  const char *prefix = STATS_SHM_PREFIX + 1;
+  struct dirent *de;
+  DIR *dir = opendir(SHM_DIR);
+  int found = 0;
+
+  if (!dir)
+    return 0;
+
+  while ((de = readdir(dir))) {
+    /* a longer name would not fit name with its leading '/' */
+    if (strncmp(de->d_name, prefix, strlen(prefix)) ||
+        strlen(de->d_name) + 2 > len)
+      continue;
+    if (!found)
+      snprintf(name, len, "/%s", de->d_name);
+    if (list)
+      printf("/%s\n", de->d_name);
+    found++;
+  }
+  closedir(dir);
+  return found;
+}
+
+static const struct stats_block *map_block(const char *name) {
+  const struct stats_block *block;
+  int fd = shm_open(name, O_RDONLY, 0);
+
+  if (fd < 0) {
+    printf("cannot open %s: %s\n", name, strerror(errno));
+    return NULL;
+  }
+  block = mmap(NULL, sizeof(*block), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (block == MAP_FAILED) {
+    printf("cannot map %s: %s\n", name, strerror(errno));
+    return NULL;
+  }
+
+  if (__atomic_load_n(&block->magic, __ATOMIC_ACQUIRE) != STATS_MAGIC ||
+      block->version != STATS_VERSION ||
+      block->func_count > STATS_MAX_FUNCS) {
+    printf("%s is not a g2d statistics block of version %d\n", name,
+           STATS_VERSION);
+    munmap((void *)block, sizeof(*block));
+    return NULL;
+  }
+  return block;
+}
+
+/* Upper bound in us of the bucket holding the pct percentile of the delta. */
+static unsigned long long delta_percentile(const struct stats_counter *cur,
+                                           const struct stats_counter *prev,
+                                           int pct) {
+  unsigned long long calls = cur->calls - prev->calls;
+  unsigned long long seen = 0, rank = (calls * pct + 99) / 100;
+  int b;
+
+  for (b = 0; b < STATS_BUCKETS - 1; b++) {
+    seen += cur->hist[b] - prev->hist[b];
+    if (seen >= rank)
+      break;
+  }
+  return 1ULL << b;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void show(const struct stats_block *cur, const struct stats_block *prev,
+                 double seconds) {
+  const struct stats_counter *fc = &cur->frames, *fp = &prev->frames;
+  unsigned long long frames = fc->calls - fp->calls;
+  int i;
+
+  /* clear the screen and home the cursor */
+  printf("\033[H\033[2J");
+  printf("g2d_top - %s (pid %d), %.1fs interval\n\n", cur->process, cur->pid,
+         seconds);
+
+  if (frames)
+    printf("frames: %.1f fps, avg %.2fms, p50 <%llu us, p99 <%llu us, "
+           "total %llu\n\n",
+           frames / seconds, (fc->total_ns - fp->total_ns) / 1e6 / frames,
+           delta_percentile(fc, fp, 50), delta_percentile(fc, fp, 99),
+           fc->calls);
+  else
+    printf("frames: none, total %llu\n\n", fc->calls);
+
+  printf("%-26s %9s %9s %8s %8s %9s %9s %10s\n", "function", "calls/s",
+         "avg us", "p50 <us", "p99 <us", "Mpixel/s", "MB/s", "total");
+
+  for (i = 0; i < cur->func_count; i++) {
+    const struct stats_counter *c = &cur->funcs[i], *p = &prev->funcs[i];
+    unsigned long long calls = c->calls - p->calls;
+
+    if (!c->calls)
+      continue;
+
+    if (!calls) {
+      printf("%-26s %9s %9s %8s %8s %9s %9s %10llu\n", c->name, "-", "-", "-",
+             "-", "-", "-", c->calls);
+      continue;
+    }
+
+    printf("%-26s %9.1f %9.1f %8llu %8llu %9.2f %9.1f %10llu\n", c->name,
+           calls / seconds, (c->total_ns - p->total_ns) / 1e3 / calls,
+           delta_percentile(c, p, 50), delta_percentile(c, p, 99),
+           (c->pixels - p->pixels) / 1e6 / seconds,
+           (c->bytes - p->bytes) / 1e6 / seconds,
+           c->calls);
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+  const struct stats_block *block;
+  struct stats_block prev, cur;
+  char name[NAME_MAX + 2];
+  double t_prev, t_cur;
+  int interval_ms = 1000, count = 0, list = 0, n = 0, opt;
+
+  while ((opt = getopt(argc, argv, "i:n:lh")) != -1) {
+    switch (opt) {
+    case 'i':
+      interval_ms = atoi(optarg);
+      break;
+    case 'n':
+      count = atoi(optarg);
+      break;
+    case 'l':
+      list = 1;
+      break;
+    default:
+      usage(argv[0]);
+      return opt == 'h' ? 0 : 1;
+    }
+  }
+  if (interval_ms <= 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if (list)
+    return find_blocks(name, sizeof(name), 1) ? 0 : 1;
+
+  if (optind < argc) {
+    if (argv[optind][0] == '/')
+      snprintf(name, sizeof(name), "%s", argv[optind]);
+    else
+      snprintf(name, sizeof(name), "%s%d", STATS_SHM_PREFIX,
+               atoi(argv[optind]));
+  } else if (!find_blocks(name, sizeof(name), 0)) {
+    printf("no process publishes g2d statistics, run it with %s=1 and "
+           "libg2d_prof.so preloaded\n",
+           STATS_SHM_ENV);
+    return 1;
+  }
+
+  block = map_block(name);
+  if (!block)
+    return 1;
+
+  memcpy(&prev, block, sizeof(prev));
+  t_prev = now_s();
+  while (!count || n++ < count) {
+    usleep(interval_ms * 1000);
+    memcpy(&cur, block, sizeof(cur));
+    t_cur = now_s();
+    show(&cur, &prev, t_cur - t_prev);
+    prev = cur;
+    t_prev = t_cur;
+
+    if (kill(cur.pid, 0) && errno == ESRCH) {
+      printf("\nprocess %d exited\n", cur.pid);
+      break;
+    }
+  }
+
+  munmap((void *)block, sizeof(*block));
+  return 0;
+}
@@ -17,6 +17,7 @@
 #include <sys/time.h>
 
 #include "g2dExt.h"
+#include "g2d_format.h"
 #include "warp_buffer.h"
 #include "warp_buffer_1080p.h"
 #include "warp_buffer_4k.h"
@@ -52,45 +53,6 @@ fprintf(stderr, "Usage: cmd [options]\n"
 				"\n");
 }
 
-static uint32_t get_buffer_size(uint16_t width, uint16_t height, enum g2d_format format)
-{
-	switch (format) {
-	case G2D_RGBA8888:
-	case G2D_RGBX8888:
-	case G2D_BGRA8888:
-	case G2D_BGRX8888:
-	case G2D_ARGB8888:
-	case G2D_ABGR8888:
-	case G2D_XRGB8888:
-	case G2D_XBGR8888:
-		return width * height * 4;
-
-	case G2D_RGB888:
-	case G2D_BGR888:
-		return width * height * 3;
-
-	case G2D_RGB565:
-	case G2D_BGR565:
-		return width * height * 2;
-
-	case G2D_NV12:
-	case G2D_NV21:
-		return width * height * 3 / 2;
-
-	case G2D_YUYV:
-	case G2D_YVYU:
-	case G2D_UYVY:
-	case G2D_VYUY:
-		return width * height * 2;
-
-	default:
-		fprintf(stderr, "Unsupported format!\n");
-		exit(EXIT_FAILURE);
-	}
-
-	return 0;
-}
-
 static int g2d_init(struct ctx *ctx, int width, int height,
 		    enum g2d_format in_format, enum g2d_format out_format,
 		    enum  g2d_warp_map_format coord_format)
@@ -108,9 +70,6 @@ static int g2d_init(struct ctx *ctx, int width, int height,
 		return -1;
 	}
 
-	ctx->s_buf = g2d_alloc(get_buffer_size(width, height, in_format), 0);
-	ctx->d_buf = g2d_alloc(get_buffer_size(width, height, out_format), 0);
-
 	ctx->src.left = 0;
 	ctx->src.top = 0;
 	ctx->src.right = width;
@@ -119,11 +78,7 @@ static int g2d_init(struct ctx *ctx, int width, int height,
 	ctx->src.height = height;
 	ctx->src.format = in_format;
 	ctx->src.stride = width;
-	ctx->src.planes[0] = ctx->s_buf->buf_paddr;
-	if (in_format == G2D_NV12 ||
-	    in_format == G2D_NV21)
-		ctx->src.planes[1] = ctx->s_buf->buf_paddr +
-				     width * height;
+	ctx->s_buf = format_alloc(&ctx->src, NULL, 0);
 
 	ctx->dst.left = 0;
 	ctx->dst.top = 0;
@@ -133,11 +88,11 @@ static int g2d_init(struct ctx *ctx, int width, int height,
 	ctx->dst.height = height;
 	ctx->dst.format = out_format;
 	ctx->dst.stride = width;
-	ctx->dst.planes[0] = ctx->d_buf->buf_paddr;
-	if (out_format == G2D_NV12 ||
-	    out_format == G2D_NV21)
-		ctx->dst.planes[1] = ctx->d_buf->buf_paddr +
-				     width * height;
+	ctx->d_buf = format_alloc(&ctx->dst, NULL, 0);
+
+	/* format_alloc printed why */
+	if (!ctx->s_buf || !ctx->d_buf)
+		return -1;
 
 	ctx->coord_buf = g2d_alloc(width * height * 4, 0);
 	ctx->coord.addr = ctx->coord_buf->buf_paddr;
@@ -362,6 +317,7 @@ int main(int argc, char **argv)
 	void *warp_coord_absolute;
 	void *dewarp_coord_absolute;
 	struct timeval tv1, tv2;
+	struct format_layout layout;
 	int i, diff;
 	int test_loop = 16;
 
@@ -484,8 +440,8 @@ int main(int argc, char **argv)
 	/* === now test that de-warping works === */
 
 	/* copy the warped buffer to the source buffer */
-	memcpy(ctx.s_buf->buf_vaddr, ctx.d_buf->buf_vaddr,
-	       get_buffer_size(fb_width, fb_height, G2D_BGRA8888));
+	format_layout(G2D_BGRA8888, fb_width, fb_height, 0, &layout);
+	memcpy(ctx.s_buf->buf_vaddr, ctx.d_buf->buf_vaddr, layout.total);
 
 	/* copy the dewarping coordinates buffer to the contiguous allocated memory */
 	memcpy(ctx.coord_buf->buf_vaddr, dewarp_coord_absolute,
@@ -24,84 +24,54 @@
 #include "test_context.h"
 #include <g2dExt.h>
 
-#define CACHEABLE 0
+#include "g2d_alloc_stats.h"
+#include "g2d_cache_policy.h"
+#include "g2d_format.h"
+#include "g2d_trace.h"
+
 #define FRAMES 30
 
+/* Source images are read once into g2d buffers kept until test_teardown. */
+#define SOURCE_CACHE_SIZE 16
+
+struct source_image {
+  const char *fname;
+  struct g2d_buf *buf;
+  size_t size;
+};
+
+static struct source_image source_cache[SOURCE_CACHE_SIZE];
+static int source_count;
+
 static void g2d_fill_buffer(test_context *tc) {
   struct g2d_surfaceEx srcEx, dstEx;
   struct g2d_surface *src = &srcEx.base;
   struct g2d_surface *dst = &dstEx.base;
-  struct g2d_buf *buf = NULL;
-  void *g2dHandle;
+  struct g2d_buf *buf = tc->src_buf;
+  struct format_layout layout;
+  void *g2dHandle = tc->g2d_handle;
 
-  if (g2d_open(&g2dHandle) == -1 || g2dHandle == NULL) {
+  if (tc->session_per_frame && g2d_open(&g2dHandle) == -1)
+    g2dHandle = NULL;
+  if (g2dHandle == NULL) {
     fprintf(stderr, "Fail to open g2d device!\n");
     return;
   }
 
-  // alloc physical contiguous memory for source image data
-  buf = g2d_alloc(tc->src_sz, CACHEABLE);
-  if (!buf) {
-    fprintf(stderr, "Fail to allocate physical memory for image buffer!\n");
-    goto OnError;
-  }
-
-  memcpy(buf->buf_vaddr, tc->src_buf, tc->src_sz);
-
-#if CACHEABLE
-  g2d_cache_op(buf, G2D_CACHE_FLUSH);
-#endif
-
   /*
-   NOTE: in this example, all the test image data meet with the alignment
-   requirement. Thus, in your code, you need to pay attention on that.
-
-   Pixel buffer address alignment requirement,
-   RGB/BGR: pixel data in planes [0] with 16bytes alignment,
-   NV12/NV16: Y in planes [0], UV in planes [1], with 64bytes alignment,
-   I420: Y in planes [0], U in planes [1], V in planes [2], with 64 bytes
-   alignment,
-   YV12: Y in planes [0], V in planes [1], U in planes [2], with 64 bytes
-   alignment,
-   NV21/NV61: Y in planes [0], VU in planes [1], with 64 bytes alignment,
-   YUYV/YVYU/UYVY/VYUY: in planes[0], buffer address is with 16 bytes alignment.
+  The raw test images hold their planes back to back. g2d_format.h gives the
+  plane address alignment each format requires, 16 bytes for RGB and packed
+  YUV and 64 bytes for each plane of NV12/NV16/I420, which the test images
+  meet. In your code, lay out the planes with format_alloc instead.
   */
 
   src->format = tc->src_color_format;
-  switch (src->format) {
-  case G2D_RGB565:
-  case G2D_RGBA8888:
-  case G2D_RGBX8888:
-  case G2D_BGRA8888:
-  case G2D_BGRX8888:
-  case G2D_BGR565:
-  case G2D_YUYV:
-  case G2D_UYVY:
-  default:
-    src->planes[0] = buf->buf_paddr;
-    break;
-  case G2D_NV21:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + tc->src_width * tc->src_height;
-    break;
-  case G2D_NV12:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + tc->src_width * tc->src_height;
-    break;
-  case G2D_I420:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + tc->src_width * tc->src_height;
-    src->planes[2] = src->planes[1] + tc->src_width * tc->src_height / 4;
-    break;
-  case G2D_NV16:
+  /* formats missing from the table only use planes[0] */
+  if (format_layout(src->format, tc->src_width, tc->src_height, FORMAT_PACKED,
+                    &layout))
     src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + tc->src_width * tc->src_height;
-    break;
-  case G2D_NV61:
-    src->planes[0] = buf->buf_paddr;
-    src->planes[1] = buf->buf_paddr + tc->src_width * tc->src_height;
-    break;
-  }
+  else
+    format_set_planes(src, buf, &layout);
 
   srcEx.tiling = tc->src_tiling;
   dstEx.tiling = G2D_LINEAR;
@@ -154,44 +124,81 @@ static void g2d_fill_buffer(test_context *tc) {
     g2d_disable(g2dHandle, G2D_BLUR);
   }
 
-OnError:
-  if (buf)
-    g2d_free(buf);
-  g2d_close(g2dHandle);
+  if (tc->session_per_frame)
+    g2d_close(g2dHandle);
 }
 
-static bool read_file(const char *fname, void **out_buf, size_t *out_sz) {
-  int fd = open(fname, O_RDONLY);
+/*
+ * Reads fname straight into a g2d buffer on first use. The raw files hold
+ * their planes back to back, as g2d_fill_buffer lays them out.
+ */
+static struct g2d_buf *load_source(const char *fname, size_t *out_sz) {
+  struct source_image *image;
+  struct g2d_buf *buf;
+  struct stat statbuf;
+  ssize_t rv = 0;
+  size_t done = 0;
+  int i, fd;
+
+  for (i = 0; i < source_count; i++) {
+    if (!strcmp(source_cache[i].fname, fname)) {
+      *out_sz = source_cache[i].size;
+      return source_cache[i].buf;
+    }
+  }
+  if (source_count == SOURCE_CACHE_SIZE) {
+    fprintf(stderr, "too many source images, %s not loaded\n", fname);
+    return NULL;
+  }
+
+  fd = open(fname, O_RDONLY);
   if (fd < 0) {
     fprintf(stderr, "can't open %s: %s\n", fname, strerror(errno));
-    return false;
+    return NULL;
   }
-  struct stat statbuf;
-  int rv = fstat(fd, &statbuf);
-  if (rv) {
+  if (fstat(fd, &statbuf)) {
     fprintf(stderr, "fstat(%s) failed: %s\n", fname, strerror(errno));
-    return false;
+    close(fd);
+    return NULL;
   }
 
-  uint8_t *buf = malloc(statbuf.st_size);
-  rv = read(fd, buf, statbuf.st_size);
-  if (!rv) {
-    fprintf(stderr, "can't read %s: %s\n", fname, strerror(errno));
+  // alloc physical contiguous memory for source image data
+  buf = cache_policy_alloc(statbuf.st_size, CACHE_CPU_WRITE_ONCE);
+  if (!buf) {
+    fprintf(stderr, "Fail to allocate physical memory for image buffer!\n");
     close(fd);
-    return false;
+    return NULL;
   }
 
+  trace_begin("io", "read");
+  while (done < (size_t)statbuf.st_size) {
+    rv = read(fd, (uint8_t *)buf->buf_vaddr + done, statbuf.st_size - done);
+    if (rv <= 0)
+      break;
+    done += rv;
+  }
+  trace_end("io", "read");
   close(fd);
-  *out_sz = statbuf.st_size;
-  *out_buf = buf;
-
-  return true;
+  if (rv <= 0) {
+    fprintf(stderr, "can't read %s: %s\n", fname,
+            rv ? strerror(errno) : "short file");
+    cache_policy_free(buf);
+    return NULL;
+  }
+  cache_policy_cpu_done(buf);
+
+  image = &source_cache[source_count++];
+  image->fname = fname;
+  image->buf = buf;
+  image->size = statbuf.st_size;
+  *out_sz = image->size;
+  return buf;
 }
 
 static void test_color_format(test_context *tc, const char *fname,
                               unsigned src_color_format) {
-  bool rv = read_file(fname, &tc->src_buf, &tc->src_sz);
-  if (!rv)
+  tc->src_buf = load_source(fname, &tc->src_sz);
+  if (!tc->src_buf)
     return;
 
   tc->src_width = 1024;
@@ -205,7 +212,6 @@ static void test_color_format(test_context *tc, const char *fname,
   // G2D_BGRA8888, stored as big-endian.
   tc->dst_color_format = G2D_BGRA8888;
   g2d_fill_buffer(tc);
-  free(tc->src_buf);
 }
 
 void paint_pixels(test_context *tc) {
@@ -328,5 +334,29 @@ void paint_pixels(test_context *tc) {
 #endif
 
   fprintf(stderr, "\nTest complete!\n");
+  test_teardown(tc);
   exit(0);
 }
+
+void test_setup(test_context *tc) {
+  const char *per_frame = getenv(SESSION_PER_FRAME_ENV);
+
+  tc->session_per_frame = per_frame && atoi(per_frame);
+  if (tc->session_per_frame)
+    return;
+
+  if (g2d_open(&tc->g2d_handle) == -1 || tc->g2d_handle == NULL) {
+    fprintf(stderr, "Fail to open g2d device!\n");
+    tc->g2d_handle = NULL;
+  }
+}
+
+void test_teardown(test_context *tc) {
+  while (source_count)
+    cache_policy_free(source_cache[--source_count].buf);
+  tc->src_buf = NULL;
+
+  if (tc->g2d_handle)
+    g2d_close(tc->g2d_handle);
+  tc->g2d_handle = NULL;
+}
@@ -23,6 +23,9 @@
 
 #include "test_context.h"
 #include <g2dExt.h>
+#include "g2d_alloc_stats.h"
+#include "g2d_frame_stats.h"
+#include "g2d_trace.h"
 #include "xdg-shell-client-protocol.h"
 
 struct wl_display *g_display = NULL;
@@ -83,11 +86,6 @@ static struct wl_buffer *create_buffer(test_context *tc) {
   int fd;
   struct wl_buffer *buff;
 
-  void *g2dHandle;
-  if (g2d_open(&g2dHandle) == -1 || g2dHandle == NULL) {
-    fprintf(stderr, "g2d_open failed\n");
-    return NULL;
-  }
   struct g2d_buf *g2d_data = g2d_alloc(size, 0);
   if (g2d_data == NULL) {
     fprintf(stderr, "g2d_alloc failed\n");
@@ -122,6 +120,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
     return;
   test_context *tc = (test_context *)data;
 
+  trace_begin("wayland", "frame");
+  frame_stats_begin();
   wl_callback_destroy(g_frame_callback);
   wl_surface_damage(g_surface, 0, 0, tc->dst_width, tc->dst_height);
 
@@ -131,6 +131,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
   wl_surface_attach(g_surface, g_buffer, 0, 0);
   wl_callback_add_listener(g_frame_callback, &frame_listener, tc);
   wl_surface_commit(g_surface);
+  frame_stats_end();
+  trace_end("wayland", "frame");
 }
 
 static const struct wl_callback_listener frame_listener = {redraw};
@@ -284,7 +286,10 @@ int main(int argc, char **argv) {
   if (!surface_create(g_compositor, &g_surface))
     exit(1);
 
+  frame_stats_init();
+
   test_context *tc = test_context_alloc(1024, 768);
+  test_setup(tc);
 
   if (!set_frame_callback(&g_frame_callback, tc))
     exit(1);
@@ -296,12 +301,13 @@ int main(int argc, char **argv) {
   if (!wait_for_configure)
     redraw(tc, NULL, 0);
 
-  while (wl_display_dispatch(g_display) != -1) {
+  while (frame_stats_running() && wl_display_dispatch(g_display) != -1) {
     ;
   }
 
   wl_display_disconnect(g_display);
   fprintf(stderr, "Disconnected from display\n");
 
+  test_teardown(tc);
   exit(0);
 }
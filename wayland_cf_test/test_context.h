@@ -10,7 +10,13 @@
 
 #include <unistd.h>
 
+/* Set to 1 to open and close g2d on every frame, as the test used to. */
+#define SESSION_PER_FRAME_ENV "G2D_SESSION_PER_FRAME"
+
 typedef struct {
+  void *g2d_handle; /* from test_setup to test_teardown */
+  int session_per_frame;
+
   void *dst_vaddr;
   int dst_paddr;
 
@@ -23,7 +29,7 @@ typedef struct {
 
   unsigned src_color_format;
   unsigned src_tiling;
-  void *src_buf;
+  struct g2d_buf *src_buf; /* owned by the source image cache */
   size_t src_sz;
   size_t src_width;
   size_t src_height;
@@ -34,3 +40,5 @@ typedef struct {
 
 extern test_context *test_context_alloc(size_t dst_width, size_t dst_height);
 extern void paint_pixels(test_context *tc);
+extern void test_setup(test_context *tc);
+extern void test_teardown(test_context *tc);
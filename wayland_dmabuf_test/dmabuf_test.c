@@ -22,6 +22,9 @@
 #include "test_context.h"
 #include <g2dExt.h>
 
+#include "g2d_alloc_stats.h"
+#include "g2d_trace.h"
+
 #define SIGN_MASK 0x80000000UL
 #define BUFFER_ROTATION 0
 
@@ -39,7 +42,6 @@ struct client_buffer {
 };
 
 struct test_data {
-  void *g2d_handle;
   struct g2d_buf *src_layer;
 #if BUFFER_ROTATION
   struct g2d_buf *coord_layer;
@@ -522,7 +524,7 @@ static void g2d_fill_buffer(test_context *tc,
   struct coordinate_buffer *coord_buf = td->coord_buf;
 #endif
 
-  void *g2dHandle = td->g2d_handle;
+  void *g2dHandle = tc->g2d_handle;
 
 #if 0
   unsigned matrix[] = {
@@ -613,7 +615,7 @@ void test_setup(test_context *tc) {
   );
 #endif
 
-  if (g2d_open(&td->g2d_handle) == -1 || td->g2d_handle == NULL) {
+  if (g2d_open(&tc->g2d_handle) == -1 || tc->g2d_handle == NULL) {
     fprintf(stderr, "g2d_open failed\n");
     return;
   }
@@ -655,6 +657,9 @@ void test_setup(test_context *tc) {
 void test_teardown(test_context *tc) {
   struct test_data *td = (struct test_data *)tc->user_data;
 
+  if (!td)
+    return;
+
 #if BUFFER_ROTATION
   free(td->coord_buf);
 #if 0
@@ -665,7 +670,8 @@ void test_teardown(test_context *tc) {
 #endif
   g2d_free(td->src_layer);
 
-  g2d_close(td->g2d_handle);
+  g2d_close(tc->g2d_handle);
+  tc->g2d_handle = NULL;
 
   free(tc->user_data);
   tc->user_data = NULL;
@@ -24,6 +24,9 @@
 #include "linux_dmabuf_wp.h"
 #include "test_context.h"
 #include <g2dExt.h>
+#include "g2d_alloc_stats.h"
+#include "g2d_frame_stats.h"
+#include "g2d_trace.h"
 #include "xdg-shell-client-protocol.h"
 
 struct wl_display *g_display = NULL;
@@ -122,6 +125,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
 
   test_context *tc = (test_context *)data;
 
+  trace_begin("wayland", "frame");
+  frame_stats_begin();
   client_buffer = window_next_buffer(tc);
 
   if (callback)
@@ -137,6 +142,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
   wl_surface_commit(g_surface);
 
   client_buffer->busy = 1;
+  frame_stats_end();
+  trace_end("wayland", "frame");
 }
 
 static const struct wl_callback_listener frame_listener = {redraw};
@@ -152,12 +159,6 @@ static bool create_g2d_buffer(test_context *tc, struct client_buffer *buf) {
   int stride = tc->window_width * 4; // 4 bytes per pixel
   int size = stride * tc->window_height;
 
-  void *g2dHandle;
-  if (g2d_open(&g2dHandle) == -1 || g2dHandle == NULL) {
-    fprintf(stderr, "create_buffer: g2d_open failed\n");
-    return false;
-  }
-
   buf->g2d_data = g2d_alloc(size, 0);
   if (buf->g2d_data == NULL) {
     fprintf(stderr, "create_buffer: g2d_alloc failed\n");
@@ -172,7 +173,6 @@ static bool create_g2d_buffer(test_context *tc, struct client_buffer *buf) {
 
   buf->stride = stride;
 
-  g2d_close(g2dHandle);
   return true;
 }
 
@@ -418,6 +418,8 @@ int main(int argc, char **argv) {
   if (!surface_create(g_compositor, &g_surface))
     exit(1);
 
+  frame_stats_init();
+
   test_context *tc = test_context_alloc(1024, 768);
   tc->dmabuffers[0] = test_buffer_new();
   tc->dmabuffers[1] = test_buffer_new();
@@ -427,15 +429,15 @@ int main(int argc, char **argv) {
   if (!xdg_shell_surface_create(g_surface, &g_xdg_surface, &g_xdg_toplevel, tc))
     exit(1);
 
+  test_setup(tc);
+
   if (!create_window(tc))
     exit(1);
 
-  test_setup(tc);
-
   if (!wait_for_configure)
     redraw(tc, NULL, 0);
 
-  while (wl_display_dispatch(g_display) != -1) {
+  while (frame_stats_running() && wl_display_dispatch(g_display) != -1) {
     ;
   }
 
@@ -448,6 +450,7 @@ int main(int argc, char **argv) {
   if(tc->dmabuffers[1]->g2d_data != NULL) {
     g2d_free(tc->dmabuffers[1]->g2d_data);
   }
+  test_teardown(tc);
 
   free(tc->dmabuffers[0]);
   free(tc->dmabuffers[1]);
@@ -13,6 +13,7 @@
 struct client_buffer;
 
 typedef struct {
+  void *g2d_handle; /* from test_setup to test_teardown */
   void *shm_data;
   int phy_data;
   size_t window_width;
@@ -25,3 +26,4 @@ typedef struct {
 extern test_context *test_context_alloc(size_t width, size_t height);
 extern void paint_pixels(test_context *tc, struct client_buffer *client_buffer);
 extern void test_setup(test_context *tc);
+extern void test_teardown(test_context *tc);
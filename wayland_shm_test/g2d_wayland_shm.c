@@ -23,6 +23,9 @@
 
 #include "test_context.h"
 #include <g2dExt.h>
+#include "g2d_alloc_stats.h"
+#include "g2d_frame_stats.h"
+#include "g2d_trace.h"
 #include "xdg-shell-client-protocol.h"
 
 struct wl_display *g_display = NULL;
@@ -82,20 +85,27 @@ static struct wl_buffer *create_buffer(test_context *tc) {
   int size = stride * tc->height;
   int fd;
   struct wl_buffer *buff;
+  struct g2d_buf *g2d_data;
+  void *handle = NULL;
 
-  void *g2dHandle;
-  if (g2d_open(&g2dHandle) == -1 || g2dHandle == NULL) {
+  /* test_setup keeps no session in per frame mode, g2d_alloc needs one */
+  if (tc->session_per_frame && g2d_open(&handle) == -1) {
     fprintf(stderr, "g2d_open failed\n");
     return NULL;
   }
-  struct g2d_buf *g2d_data = g2d_alloc(size, 0);
+  g2d_data = g2d_alloc(size, 0);
   if (g2d_data == NULL) {
     fprintf(stderr, "g2d_alloc failed\n");
+    if (handle)
+      g2d_close(handle);
     return NULL;
   }
   fd = g2d_buf_export_fd(g2d_data);
+  if (handle)
+    g2d_close(handle);
   if (fd < 0) {
     fprintf(stderr, "g2d_buf_export_fd failed\n");
+    g2d_free(g2d_data);
     return NULL;
   }
 
@@ -108,7 +118,6 @@ static struct wl_buffer *create_buffer(test_context *tc) {
                                    WL_SHM_FORMAT_XRGB8888);
   // wl_buffer_add_listener(g_buffer, &buffer_listener, g_buffer);
   wl_shm_pool_destroy(pool);
-  g2d_close(g2dHandle);
   return buff;
 }
 
@@ -124,6 +133,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
     return;
   test_context *tc = (test_context *)data;
 
+  trace_begin("wayland", "frame");
+  frame_stats_begin();
   wl_callback_destroy(g_frame_callback);
   wl_surface_damage(g_surface, 0, 0, tc->width, tc->height);
 
@@ -133,6 +144,8 @@ static void redraw(void *data, struct wl_callback *callback, uint32_t time) {
   wl_surface_attach(g_surface, g_buffer, 0, 0);
   wl_callback_add_listener(g_frame_callback, &frame_listener, tc);
   wl_surface_commit(g_surface);
+  frame_stats_end();
+  trace_end("wayland", "frame");
 }
 
 static const struct wl_callback_listener frame_listener = {redraw};
@@ -286,7 +299,10 @@ int main(int argc, char **argv) {
   if (!surface_create(g_compositor, &g_surface))
     exit(1);
 
+  frame_stats_init();
+
   test_context *tc = test_context_alloc(640, 480);
+  test_setup(tc);
 
   if (!set_frame_callback(&g_frame_callback, tc))
     exit(1);
@@ -298,14 +314,18 @@ int main(int argc, char **argv) {
   if (!wait_for_configure)
     redraw(tc, NULL, 0);
 
-  while (wl_display_dispatch(g_display) != -1) {
+  while (frame_stats_running() && wl_display_dispatch(g_display) != -1) {
     ;
   }
 
   wl_display_disconnect(g_display);
   fprintf(stderr, "Disconnected from display\n");
 
+  /* free the window buffer while a session is open, then close it */
+  if (tc->session_per_frame && g2d_open(&tc->g2d_handle) == -1)
+    tc->g2d_handle = NULL;
   g2d_free(tc->g2d_data);
+  test_teardown(tc);
   free(tc);
 
   exit(0);
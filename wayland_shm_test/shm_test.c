@@ -16,6 +16,10 @@
 #include "test_context.h"
 #include <g2dExt.h>
 
+#include "g2d_alloc_stats.h"
+#include "g2d_buf_pool.h"
+#include "g2d_trace.h"
+
 // https://commons.wikimedia.org/wiki/File:EBU_Colorbars.svg
 static void ebu_color_bands(uint32_t *frame, unsigned int width,
                             unsigned int height) {
@@ -46,9 +50,11 @@ static void g2d_fill_buffer(test_context *tc) {
   struct g2d_surface *dst = &dstEx.base;
   struct g2d_buf *buf = NULL;
 
-  void *g2dHandle;
+  void *g2dHandle = tc->g2d_handle;
 
-  if (g2d_open(&g2dHandle) == -1 || g2dHandle == NULL) {
+  if (tc->session_per_frame && g2d_open(&g2dHandle) == -1)
+    g2dHandle = NULL;
+  if (g2dHandle == NULL) {
     fprintf(stderr, "g2d_open failed\n");
     return;
   }
@@ -59,7 +65,7 @@ static void g2d_fill_buffer(test_context *tc) {
   };
   g2d_set_csc_matrix(g2dHandle, matrix);
 #endif
-  buf = g2d_alloc(tc->width * tc->height * 4, 0);
+  buf = buf_pool_alloc(tc->width * tc->height * 4, 0);
   src->planes[0] = (int)buf->buf_paddr;
   src->left = 0;
   src->top = 0;
@@ -92,8 +98,9 @@ static void g2d_fill_buffer(test_context *tc) {
   g2d_blitEx(g2dHandle, &srcEx, &dstEx);
   g2d_finish(g2dHandle);
 
-  g2d_free(buf);
-  g2d_close(g2dHandle);
+  buf_pool_free(buf);
+  if (tc->session_per_frame)
+    g2d_close(g2dHandle);
 }
 
 void paint_pixels(test_context *tc) {
@@ -119,9 +126,29 @@ void paint_pixels(test_context *tc) {
       fprintf(stderr, "RGB is white, reset to black.\n");
     } else {
       fprintf(stderr, "Test complete!\n");
+      test_teardown(tc);
       exit(0);
     }
     count++;
   }
   g2d_fill_buffer(tc);
 }
+
+void test_setup(test_context *tc) {
+  const char *per_frame = getenv(SESSION_PER_FRAME_ENV);
+
+  tc->session_per_frame = per_frame && atoi(per_frame);
+  if (tc->session_per_frame)
+    return;
+
+  if (g2d_open(&tc->g2d_handle) == -1 || tc->g2d_handle == NULL) {
+    fprintf(stderr, "g2d_open failed\n");
+    tc->g2d_handle = NULL;
+  }
+}
+
+void test_teardown(test_context *tc) {
+  if (tc->g2d_handle)
+    g2d_close(tc->g2d_handle);
+  tc->g2d_handle = NULL;
+}
@@ -10,7 +10,12 @@
 
 #include <unistd.h>
 
+/* Set to 1 to open and close g2d on every frame, as the test used to. */
+#define SESSION_PER_FRAME_ENV "G2D_SESSION_PER_FRAME"
+
 typedef struct {
+  void *g2d_handle; /* from test_setup to test_teardown */
+  int session_per_frame;
   struct g2d_buf *g2d_data;
   void *shm_data;
   int phy_data;
@@ -21,3 +26,5 @@ typedef struct {
 
 extern test_context *test_context_alloc(size_t width, size_t height);
 extern void paint_pixels(test_context *tc);
+extern void test_setup(test_context *tc);
+extern void test_teardown(test_context *tc);
@@ -11,7 +11,14 @@ LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_SRC_FILES := \
-	g2d_yuv.c
+	g2d_yuv.c \
+	../common/g2d_asset.c \
+	../common/g2d_cache_policy.c \
+	../common/g2d_bench.c \
+	../common/g2d_format.c \
+	../common/g2d_trace.c \
+	../common/g2d_alloc_stats.c \
+	../common/g2d_cache_stats.c
 
 LOCAL_SHARED_LIBRARIES := libutils libc liblog
 
@@ -21,7 +28,8 @@ else
 LOCAL_SHARED_LIBRARIES += libg2d
 endif
 
-LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../include/ \
+LOCAL_C_INCLUDES += $(LOCAL_PATH)/../common \
+		    $(LOCAL_PATH)/../../include/ \
 		    $(FSL_PROPRIETARY_PATH)/fsl-proprietary/include
 
 LOCAL_VENDOR_MODULE := true
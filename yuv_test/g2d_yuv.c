@@ -25,11 +25,15 @@
 
 #include <g2dExt.h>
 
+#include "g2d_asset.h"
+#include "g2d_bench.h"
+#include "g2d_cache_policy.h"
+#include "g2d_format.h"
+
 #define TRUE 1
 #define FALSE 0
 #define TEST_LOOP 16
 
-#define CACHEABLE 0
 
 #define Timespec_Double(t)                                                     \
   ((double)((t)->tv_sec) + (1.e-9 * (double)((t)->tv_nsec)))
@@ -142,25 +146,26 @@ static bool parseFormat(const char *fmtStr, int *pSrcFmt, int *pDstFmt) {
 void *_g2d_handle;
 
 int OpenG2D(void);
-int CreateG2DBuffer(struct g2d_buf **buf, int size);
 void ReleaseG2DBuffer(struct g2d_buf *buf);
 void CloseG2D(void);
 
 int main(int argc, char **argv) {
-  FILE *fpin, *fpout;
+  struct asset_map in;
+  FILE *fpout;
   int srcStride = 0, dstStride = 0;
-  int i;
   static struct timespec t1 = {0, 0};
   static struct timespec t2 = {0, 0};
   struct timespec diff;
+  struct bench_run run;
   double t;
   int srcWidth = 0, srcHeight = 0, dstWidth = 0, dstHeight = 0;
   char *inFile;
   char *outFile = "output.yuv";
   int srcFmt = G2D_YUYV;
   int dstFmt = G2D_YUYV;
-  size_t size_r = 0;
+  int short_file = 0;
   int ret = 0;
+  int i;
 
   while (true) {
     int optionIndex;
@@ -241,8 +246,7 @@ int main(int argc, char **argv) {
   }
 
   // opens data files
-  fpin = fopen(inFile, "rb");
-  if (!fpin) {
+  if (asset_map(inFile, &in)) {
     printf("FAILED to open source file\n");
     return -EACCES;
   }
@@ -263,52 +267,16 @@ int main(int argc, char **argv) {
   if (0 == dstStride)
     dstStride = dstWidth;
 
-  struct g2d_buf *srcYBuf = NULL;
-  struct g2d_buf *srcUBuf = NULL;
-  struct g2d_buf *srcVBuf = NULL;
-  struct g2d_buf *dstYBuf = NULL;
-  struct g2d_buf *dstUBuf = NULL;
-  struct g2d_buf *dstVBuf = NULL;
+  struct g2d_buf *srcBuf = NULL;
+  struct g2d_buf *dstBuf = NULL;
+  struct format_layout srcLayout, dstLayout, fileLayout;
 
   ret = OpenG2D();
   if (0 != ret) {
     return ret;
   }
+  bench_run_init(&run, TEST_LOOP);
 
-  if (G2D_YUYV == srcFmt) {
-    CreateG2DBuffer(&srcYBuf, srcWidth * 2 * srcHeight);
-    size_r = fread(srcYBuf->buf_vaddr, 1, srcWidth * 2 * srcHeight, fpin);
-  } else if (G2D_NV12 == srcFmt) {
-    CreateG2DBuffer(&srcYBuf, srcStride * srcHeight);
-    size_r = fread(srcYBuf->buf_vaddr, 1, srcWidth * srcHeight, fpin);
-    CreateG2DBuffer(&srcUBuf, srcStride * srcHeight / 2);
-    size_r = fread(srcUBuf->buf_vaddr, 1, srcWidth * srcHeight / 2, fpin);
-    fseek(fpin, srcStride * srcHeight, SEEK_SET);
-  } else if (G2D_I420 == srcFmt) {
-    CreateG2DBuffer(&srcYBuf, srcStride * srcHeight);
-    size_r = fread(srcYBuf->buf_vaddr, 1, srcWidth * srcHeight, fpin);
-    CreateG2DBuffer(&srcUBuf, srcStride * srcHeight / 4);
-    size_r = fread(srcUBuf->buf_vaddr, 1, srcWidth * srcHeight / 4, fpin);
-    CreateG2DBuffer(&srcVBuf, srcStride * srcHeight / 4);
-    size_r = fread(srcVBuf->buf_vaddr, 1, srcWidth * srcHeight / 4, fpin);
-    fseek(fpin, srcStride * srcHeight, SEEK_SET);
-  }
-
-  if (G2D_YUYV == dstFmt) {
-    CreateG2DBuffer(&dstYBuf, dstWidth * 2 * dstHeight);
-  } else if (G2D_NV12 == dstFmt) {
-    CreateG2DBuffer(&dstYBuf, dstStride * dstHeight);
-    CreateG2DBuffer(&dstUBuf, dstStride * dstHeight / 2);
-  } else if (G2D_I420 == dstFmt) {
-    CreateG2DBuffer(&dstYBuf, dstStride * dstHeight);
-    CreateG2DBuffer(&dstUBuf, dstStride * dstHeight / 4);
-    CreateG2DBuffer(&dstVBuf, dstStride * dstHeight / 4);
-  }
-
-  printf("inFile=%s, src, wxh=%dx%d, stride=%d, srcFmt=%d\n", inFile, srcWidth,
-         srcHeight, srcStride, srcFmt);
-  printf("outFile=%s, dst, wxh=%dx%d, stride=%d, dstFmt=%d\n", outFile,
-         dstWidth, dstHeight, dstStride, dstFmt);
   ////////////////////----------------------------------------
   struct g2d_surfaceEx *srcEx;
   struct g2d_surfaceEx *dstEx;
@@ -325,16 +293,8 @@ int main(int argc, char **argv) {
   src->bottom = srcHeight;
   src->width = srcWidth;
   src->height = srcHeight;
+  src->stride = srcStride;
   src->format = srcFmt;
-  if (G2D_YUYV == src->format) {
-    src->stride = srcStride;
-    printf("change yuyv stride to %d\n", src->stride);
-    src->planes[0] = srcYBuf->buf_paddr;
-  } else if (G2D_NV12 == src->format) {
-    src->stride = srcWidth;
-    src->planes[0] = srcYBuf->buf_paddr;
-    src->planes[1] = srcUBuf->buf_paddr;
-  }
 
   dst->right = dstWidth;
   dst->bottom = dstHeight;
@@ -343,20 +303,49 @@ int main(int argc, char **argv) {
   dst->stride = dstStride;
   dst->format = dstFmt;
 
-  if (G2D_YUYV == dst->format) {
-    dst->planes[0] = dstYBuf->buf_paddr;
-  } else if (G2D_NV12 == dst->format) {
-    dst->planes[0] = dstYBuf->buf_paddr;
-    dst->planes[1] = dstUBuf->buf_paddr;
-  } else if (G2D_I420 == dst->format) {
-    dst->planes[0] = dstYBuf->buf_paddr;
-    dst->planes[1] = dstUBuf->buf_paddr;
-    dst->planes[2] = dstVBuf->buf_paddr;
+  // all the planes of a surface in one buffer, each 64 bytes aligned, the
+  // cacheability chosen by g2d_cache_policy from how the CPU uses them
+  format_layout(srcFmt, srcStride, srcHeight, 0, &srcLayout);
+  format_layout(dstFmt, dstStride, dstHeight, 0, &dstLayout);
+  if (srcLayout.desc && dstLayout.desc) {
+    srcBuf = cache_policy_alloc(srcLayout.total, CACHE_CPU_WRITE_ONCE);
+    dstBuf = cache_policy_alloc(dstLayout.total, CACHE_CPU_READ_BACK);
+  }
+  if (!srcBuf || !dstBuf) {
+    printf("Fail to allocate physical memory !\n");
+    ReleaseG2DBuffer(srcBuf);
+    ReleaseG2DBuffer(dstBuf);
+    CloseG2D();
+    asset_unmap(&in);
+    fclose(fpout);
+    free(srcEx);
+    free(dstEx);
+    return -ENOMEM;
   }
+  format_set_planes(src, srcBuf, &srcLayout);
+  format_set_planes(dst, dstBuf, &dstLayout);
+
+  // the file holds the planes back to back, srcWidth pixels per row
+  format_layout(srcFmt, srcWidth, srcHeight, FORMAT_PACKED, &fileLayout);
+  for (i = 0; i < fileLayout.desc->planes; i++)
+    short_file |= asset_copy(&in,
+                             (char *)srcBuf->buf_vaddr + srcLayout.offset[i],
+                             fileLayout.offset[i], fileLayout.size[i]);
+  cache_policy_cpu_done(srcBuf);
+  if (short_file)
+    printf("source file %s is shorter than a %dx%d frame\n", inFile,
+           srcWidth, srcHeight);
+  asset_report(inFile, &in, 0);
+  asset_unmap(&in);
+
+  printf("inFile=%s, src, wxh=%dx%d, stride=%d, srcFmt=%s\n", inFile,
+         srcWidth, srcHeight, srcStride, srcLayout.desc->name);
+  printf("outFile=%s, dst, wxh=%dx%d, stride=%d, dstFmt=%s\n", outFile,
+         dstWidth, dstHeight, dstStride, dstLayout.desc->name);
 
   printf("\nLinear conversion start\n");
   clock_gettime(CLOCK_REALTIME, &t1);
-  for (i = 0; i < TEST_LOOP; i++) {
+  while (bench_run_next(&run, _g2d_handle)) {
     g2d_blit(_g2d_handle, src, dst); // for real converstion
   }
   g2d_finish(_g2d_handle);
@@ -364,41 +353,27 @@ int main(int argc, char **argv) {
   Timespec_Sub(&diff, &t2, &t1);
   t = 1000 * Timespec_Double(&diff);
 
-  printf("\nLinear conversion done %f ms  \n", t / TEST_LOOP);
-
-  if (G2D_YUYV == dstFmt) {
-    fwrite(dstYBuf->buf_vaddr, 1, dstStride * dstHeight, fpout);
-  } else if (G2D_NV12 == dstFmt) {
-    fwrite(dstYBuf->buf_vaddr, 1, dstStride * dstHeight, fpout);
-    fwrite(dstUBuf->buf_vaddr, 1, dstStride * dstHeight / 2, fpout);
-  } else if (G2D_I420 == dstFmt) {
-    fwrite(dstYBuf->buf_vaddr, 1, dstStride * dstHeight, fpout);
-    fwrite(dstUBuf->buf_vaddr, 1, dstStride * dstHeight / 4, fpout);
-    fwrite(dstVBuf->buf_vaddr, 1, dstStride * dstHeight / 4, fpout);
-  }
+  printf("\nLinear conversion done %f ms  \n",
+         bench_run_us(&run, t * 1000) / 1000.0);
+  bench_run_report(&run);
+
+  cache_policy_gpu_done(dstBuf);
+  for (i = 0; i < dstLayout.desc->planes; i++)
+    fwrite((char *)dstBuf->buf_vaddr + dstLayout.offset[i], 1,
+           dstLayout.size[i], fpout);
 
   printf("\nClosing opened files...");
   fclose(fpout);
-  fclose(fpin);
   printf("OK");
 
   printf("\nFinishing OpenCL...");
 
   printf("\nClosing G2D Device...");
 
-  printf("free srcY...\n");
-  ReleaseG2DBuffer(srcYBuf);
-  printf("free srcU...\n");
-  ReleaseG2DBuffer(srcUBuf);
-  printf("free srcV..\n");
-  ReleaseG2DBuffer(srcVBuf);
-
-  printf("free dstY...\n");
-  ReleaseG2DBuffer(dstYBuf);
-  printf("free dstU...\n");
-  ReleaseG2DBuffer(dstUBuf);
-  printf("free dstV...\n");
-  ReleaseG2DBuffer(dstVBuf);
+  printf("free src...\n");
+  ReleaseG2DBuffer(srcBuf);
+  printf("free dst...\n");
+  ReleaseG2DBuffer(dstBuf);
 
   CloseG2D();
   free(srcEx);
@@ -423,20 +398,10 @@ void CloseG2D(void) {
   return;
 }
 
-int CreateG2DBuffer(struct g2d_buf **buf, int size) {
-  *buf = g2d_alloc(size, CACHEABLE);
-  if (!*buf) {
-    printf("Fail to allocate physical memory !\n");
-    return -ENOMEM;
-  }
-
-  return 0;
-}
-
 void ReleaseG2DBuffer(struct g2d_buf *buf) {
   if (!buf) {
     return;
   }
 
-  g2d_free(buf);
+  cache_policy_free(buf);
 }